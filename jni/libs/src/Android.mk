@@ -115,6 +115,7 @@ LOCAL_C_INCLUDES := \
 LOCAL_SRC_FILES := \
   src/admob.cpp \
   src/analytics.cpp \
+  src/analytics_logger.cpp \
   src/camera.cpp \
   src/components/attributes.cpp \
   src/components/audio_listener.cpp \
@@ -135,15 +136,23 @@ LOCAL_SRC_FILES := \
   src/components/time_limit.cpp \
   src/default_entity_factory.cpp \
   src/default_graph_factory.cpp \
+  src/edit_dependencies.cpp \
+  src/frame_arena.cpp \
   src/full_screen_fader.cpp \
   src/game.cpp \
+  src/game_stats.cpp \
+  src/glyph_prewarm.cpp \
   src/gpg_manager.cpp \
   src/gui.cpp \
   src/inputcontrollers/android_cardboard_controller.cpp \
   src/inputcontrollers/gamepad_controller.cpp \
+  src/inputcontrollers/input_events.cpp \
   src/inputcontrollers/onscreen_controller.cpp \
   src/invites.cpp \
+  src/leaderboard_service.cpp \
+  src/level_streamer.cpp \
   src/main.cpp \
+  src/memory_accounting.cpp \
   src/messaging.cpp \
   src/modules/attributes.cpp \
   src/modules/gpg.cpp \
@@ -155,6 +164,9 @@ LOCAL_SRC_FILES := \
   src/modules/zooshi.cpp \
   src/railmanager.cpp \
   src/remote_config.cpp \
+  src/replication.cpp \
+  src/retained_text.cpp \
+  src/save_manager.cpp \
   src/states/game_menu_state.cpp \
   src/states/game_over_state.cpp \
   src/states/gameplay_state.cpp \
@@ -163,6 +175,7 @@ LOCAL_SRC_FILES := \
   src/states/pause_state.cpp \
   src/states/states_common.cpp \
   src/states/scene_lab_state.cpp \
+  src/stats_registry.cpp \
   src/unlockable_manager.cpp \
   src/world.cpp \
   src/world_renderer.cpp \
@@ -179,6 +192,7 @@ ZOOSHI_SCHEMA_FILES := \
   $(ZOOSHI_SCHEMA_DIR)/gpg.fbs \
   $(ZOOSHI_SCHEMA_DIR)/input_config.fbs \
   $(ZOOSHI_SCHEMA_DIR)/rail_def.fbs \
+  $(ZOOSHI_SCHEMA_DIR)/replication.fbs \
   $(ZOOSHI_SCHEMA_DIR)/save_data.fbs \
   $(ZOOSHI_SCHEMA_DIR)/unlockables.fbs
 
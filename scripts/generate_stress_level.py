@@ -0,0 +1,387 @@
+#!/usr/bin/python
+# Copyright 2015 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates oversized copies of the endless level for scaling tests.
+
+The shipped levels are too small to show where per-entity loops stop scaling.
+This script takes the endless level in src/rawassets as a template and lays
+out `scale` copies of it along a single rail, with configurable patron and
+scenery density, lap gating and river zone count. The result is written as
+an overlay, so the normal game and the benchmarks load it through the same
+LoadWorldDef path as the shipped levels:
+
+  generate_stress_level.py --flatc path/to/flatc --output assets --scale 100
+  zooshi stress_100x
+
+Each scale produces assets/overlays/stress_<scale>x/ containing a
+config.zooconfig whose only level is the stress level, plus its entity files.
+Output is deterministic for a given set of arguments.
+
+Above 936x a full copy of the template rail per copy would have more nodes
+than a Rail can index, so every copy keeps the same evenly spaced subset of
+the template's rail nodes instead. The rail still runs through every copy.
+"""
+
+import argparse
+import copy
+import json
+import math
+import os
+import random
+import subprocess
+import sys
+
+# The project root directory, which is one level up from this script's
+# directory.
+PROJECT_ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__),
+                                            os.path.pardir))
+
+# Directory where unprocessed assets can be found.
+RAW_ASSETS_PATH = os.path.join(PROJECT_ROOT, 'src', 'rawassets')
+
+# Location of flatbuffer schemas in this project.
+PROJECT_SCHEMA_PATH = os.path.join(PROJECT_ROOT, 'src', 'flatbufferschemas')
+
+# Schema directories of the dependencies, as passed to flatc by CMakeLists.txt.
+DEPENDENCY_SCHEMA_PATHS = [
+    os.path.join(PROJECT_ROOT, 'dependencies', 'corgi', 'component_library',
+                 'schemas'),
+    os.path.join(PROJECT_ROOT, 'dependencies', 'breadboard', 'module_library',
+                 'schemas'),
+    os.path.join(PROJECT_ROOT, 'dependencies', 'scene_lab', 'schemas'),
+    os.path.join(PROJECT_ROOT, 'dependencies', 'fplbase', 'schemas'),
+    os.path.join(PROJECT_ROOT, 'dependencies', 'motive', 'schemas'),
+    os.path.join(PROJECT_ROOT, 'dependencies', 'pindrop', 'schemas'),
+]
+
+# The level the stress levels are built from.
+TEMPLATE_LEVEL = 'Endless'
+TEMPLATE_RAIL = 'lvl_endless_rail.json'
+TEMPLATE_LIST = 'lvl_endless_list.json'
+TEMPLATE_PATRONS = 'lvl_endless_patrons.json'
+TEMPLATE_PROPS = 'lvl_endless_props.json'
+
+# Space left between copies of the template, in meters.
+COPY_MARGIN = 40.0
+
+# Positions a Rail can index: each becomes two CompactSpline nodes, which are
+# indexed with a uint16. One is left for the node that closes a wrapping rail.
+MAX_RAIL_NODES = 65535 // 2 - 1
+
+# Below this many rail nodes per copy, the rail no longer follows the turns
+# of the template.
+MIN_RAIL_NODES_PER_COPY = 8
+
+# How far extra patrons and props are moved from the entity they duplicate.
+DUPLICATE_JITTER = 4.0
+
+
+class GeneratorError(Exception):
+  """Error indicating the stress level could not be generated."""
+  pass
+
+
+def strip_comments(text):
+  """Remove // comments from JSON that flatc accepts but json does not."""
+  lines = []
+  for line in text.splitlines():
+    in_string = False
+    for i, char in enumerate(line):
+      if char == '"' and (i == 0 or line[i - 1] != '\\'):
+        in_string = not in_string
+      elif not in_string and line.startswith('//', i):
+        line = line[:i]
+        break
+    lines.append(line)
+  return '\n'.join(lines)
+
+
+def load_json(filename):
+  """Load a JSON file from src/rawassets."""
+  with open(os.path.join(RAW_ASSETS_PATH, filename)) as f:
+    return json.loads(strip_comments(f.read()))
+
+
+def find_component(entity, data_type):
+  """Returns the data of `entity`'s component of type `data_type`, or None."""
+  for component in entity['component_list']:
+    if component['data_type'] == data_type:
+      return component['data']
+  return None
+
+
+def is_first_patron(entity):
+  """True if `entity` is a "_First" patron, which starts the raft moving."""
+  meta = find_component(entity, 'corgi_MetaDef')
+  return (meta is not None and
+          meta.get('prototype', '').endswith('_First'))
+
+
+def template_extent(rail_entities):
+  """Returns the (min_x, min_y, max_x, max_y) of the template rail."""
+  positions = [find_component(e, 'corgi_TransformDef')['position']
+               for e in rail_entities]
+  return (min(p['x'] for p in positions), min(p['y'] for p in positions),
+          max(p['x'] for p in positions), max(p['y'] for p in positions))
+
+
+def copy_offsets(scale, extent):
+  """Lay the copies out on a grid, visiting the rows in alternate directions
+  so that consecutive copies, which the rail joins, are always neighbors."""
+  columns = int(math.ceil(math.sqrt(scale)))
+  step_x = extent[2] - extent[0] + COPY_MARGIN
+  step_y = extent[3] - extent[1] + COPY_MARGIN
+  offsets = []
+  for i in range(scale):
+    row = i // columns
+    column = i % columns
+    if row % 2:
+      column = columns - 1 - column
+    offsets.append((column * step_x, row * step_y))
+  return offsets
+
+
+def move_entity(entity, offset, entity_id):
+  """Returns a copy of `entity` moved by `offset` and renamed `entity_id`."""
+  entity = copy.deepcopy(entity)
+  meta = find_component(entity, 'corgi_MetaDef')
+  if meta is not None:
+    meta['entity_id'] = entity_id
+    meta.pop('comment', None)
+  transform = find_component(entity, 'corgi_TransformDef')
+  if transform is not None and 'position' in transform:
+    transform['position']['x'] += offset[0]
+    transform['position']['y'] += offset[1]
+  return entity
+
+
+def generate_rail(template, offsets):
+  """Chain a copy of the template rail through every offset.
+
+  If the chained rail would have more than MAX_RAIL_NODES nodes, each copy
+  keeps an evenly spaced subset of the template's nodes.
+  """
+  nodes_per_copy = len(template)
+  kept_per_copy = min(nodes_per_copy, MAX_RAIL_NODES // len(offsets))
+  if kept_per_copy < MIN_RAIL_NODES_PER_COPY:
+    raise GeneratorError('Scale %d needs more rail nodes than a Rail can '
+                         'index.' % len(offsets))
+  kept_nodes = [i * nodes_per_copy // kept_per_copy
+                for i in range(kept_per_copy)]
+  entities = []
+  for copy_index, offset in enumerate(offsets):
+    for node_index in kept_nodes:
+      node = template[node_index]
+      entity = move_entity(node, offset,
+                           'stress_rail_%d_%d' % (copy_index, node_index))
+      rail_node = find_component(entity, 'RailNodeDef')
+      ordering = rail_node.get('ordering', 0)
+      rail_node['ordering'] = copy_index * nodes_per_copy + ordering
+      if copy_index == 0 and node_index == 0:
+        # Only the first node carries the rail parameters. Keep the raft's
+        # speed the same by stretching the lap time with the rail.
+        if 'total_time' in rail_node:
+          rail_node['total_time'] *= len(offsets)
+      else:
+        rail_node.pop('total_time', None)
+        rail_node.pop('reliable_distance', None)
+        rail_node.pop('wraps', None)
+      entities.append(entity)
+  return entities
+
+
+def generate_population(template, offsets, density, lap_gated_fraction, laps,
+                        prefix, rng):
+  """Copy the template patrons or props next to every copy of the rail.
+
+  Each template entity is emitted `density` times on average; copies beyond
+  the first are jittered so they don't overlap. A `lap_gated_fraction` of the
+  entities only appear for one of the first `laps` laps.
+  """
+  entities = []
+  for copy_index, offset in enumerate(offsets):
+    for template_index, template_entity in enumerate(template):
+      # There must be only one "_First" patron.
+      if copy_index > 0 and is_first_patron(template_entity):
+        continue
+      count = int(density)
+      if rng.random() < density - count:
+        count += 1
+      for duplicate in range(count):
+        entity_offset = offset
+        if duplicate > 0:
+          entity_offset = (
+              offset[0] + rng.uniform(-DUPLICATE_JITTER, DUPLICATE_JITTER),
+              offset[1] + rng.uniform(-DUPLICATE_JITTER, DUPLICATE_JITTER))
+        entity = move_entity(template_entity, entity_offset, '%s_%d_%d_%d' % (
+            prefix, copy_index, template_index, duplicate))
+        if rng.random() < lap_gated_fraction:
+          min_lap = rng.randint(0, laps - 1)
+          entity['component_list'].append({
+              'data_type': 'LapDependentDef',
+              'data': {'min_lap': min_lap, 'max_lap': min_lap + 1}
+          })
+        entities.append(entity)
+  return entities
+
+
+def generate_river_zones(template_zones, zone_count):
+  """Cycle through the template's zones, spaced evenly along the river."""
+  zones = []
+  for i in range(zone_count):
+    zone = copy.deepcopy(template_zones[i % len(template_zones)])
+    zone['zone_start'] = float(i) / zone_count
+    zones.append(zone)
+  return zones
+
+
+def generate_config(scale, name, entity_files, streamed_entity_files,
+                    river_zones):
+  """Returns the game config with the stress level as its only level."""
+  config = load_json('config.json')
+  levels = config['world_def']['levels']
+  template = [l for l in levels if l['name'] == TEMPLATE_LEVEL]
+  if not template:
+    raise GeneratorError('No "%s" level in config.json' % TEMPLATE_LEVEL)
+  level = copy.deepcopy(template[0])
+  level['name'] = name
+  level['entity_files'] = entity_files
+  level['streamed_entity_files'] = streamed_entity_files
+  if not streamed_entity_files:
+    level.pop('streaming', None)
+  zones = level['river_config']['zones']
+  level['river_config']['zones'] = generate_river_zones(
+      zones, river_zones if river_zones else len(zones) * scale)
+  config['world_def']['levels'] = [level]
+  return config
+
+
+def write_flatbuffer(flatc, schema, data, json_path, output_dir, keep_json):
+  """Write `data` as JSON, then convert it to a binary with flatc."""
+  with open(json_path, 'w') as f:
+    json.dump(data, f, indent=1, sort_keys=True)
+  command = [flatc, '-b', '-o', output_dir]
+  for include in [PROJECT_SCHEMA_PATH] + DEPENDENCY_SCHEMA_PATHS:
+    command.extend(['-I', include])
+  command.extend([os.path.join(PROJECT_SCHEMA_PATH, schema), json_path])
+  if subprocess.call(command) != 0:
+    raise GeneratorError('flatc failed on %s' % json_path)
+  if not keep_json:
+    os.remove(json_path)
+
+
+def generate(args, scale):
+  """Generate the stress level for one scale."""
+  rng = random.Random(args.seed)
+  overlay = 'stress_%dx' % scale
+  output_dir = os.path.join(args.output, 'overlays', overlay)
+  if not os.path.isdir(output_dir):
+    os.makedirs(output_dir)
+
+  rail_template = load_json(TEMPLATE_RAIL)['entity_list']
+  offsets = copy_offsets(scale, template_extent(rail_template))
+  patrons = generate_population(
+      load_json(TEMPLATE_PATRONS)['entity_list'], offsets,
+      args.patron_density, args.lap_gated_fraction, args.laps,
+      'stress_patron', rng)
+  props = generate_population(
+      load_json(TEMPLATE_PROPS)['entity_list'], offsets,
+      args.scenery_density, args.lap_gated_fraction, args.laps,
+      'stress_prop', rng)
+  # The river, raft and gate are not repeated. The "_First" patron has to
+  # exist before the raft moves, so it is never streamed.
+  level_list = (load_json(TEMPLATE_LIST)['entity_list'] +
+                [e for e in patrons if is_first_patron(e)])
+  patrons = [e for e in patrons if not is_first_patron(e)]
+  # (basename, entities, streamed)
+  entity_lists = [
+      ('lvl_stress_rail', generate_rail(rail_template, offsets), False),
+      ('lvl_stress_list', level_list, False),
+      ('lvl_stress_patrons', patrons, args.streaming),
+      ('lvl_stress_props', props, args.streaming),
+  ]
+
+  # Entity files are looked up in the overlay first, so the names only need
+  # to be unique within it.
+  entity_files = []
+  streamed_entity_files = []
+  entity_count = 0
+  for basename, entities, streamed in entity_lists:
+    write_flatbuffer(args.flatc, 'components.fbs', {'entity_list': entities},
+                     os.path.join(output_dir, basename + '.json'), output_dir,
+                     args.keep_json)
+    (streamed_entity_files if streamed else entity_files).append(
+        basename + '.zooentity')
+    entity_count += len(entities)
+
+  name = 'Stress %dx' % scale
+  write_flatbuffer(args.flatc, 'config.fbs',
+                   generate_config(scale, name, entity_files,
+                                   streamed_entity_files, args.river_zones),
+                   os.path.join(output_dir, 'config.json'), output_dir,
+                   args.keep_json)
+  print('%s: %d entities in overlay %s' % (name, entity_count, overlay))
+
+
+def main():
+  """Generate a stress level for each requested scale.
+
+  Returns:
+    Returns 0 on success.
+  """
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('--flatc', default='flatc',
+                      help='Path to the flatbuffer compiler.')
+  parser.add_argument('--output', default=os.path.join(PROJECT_ROOT, 'assets'),
+                      help='Assets directory to write the overlays into.')
+  parser.add_argument('--scale', type=int, nargs='+', default=[10, 100, 1000],
+                      help='Number of copies of the endless level to chain '
+                      'together. One overlay is written per scale.')
+  parser.add_argument('--patron_density', type=float, default=1.0,
+                      help='Patrons per copy, relative to the endless level.')
+  parser.add_argument('--scenery_density', type=float, default=1.0,
+                      help='Props per copy, relative to the endless level.')
+  parser.add_argument('--lap_gated_fraction', type=float, default=0.25,
+                      help='Fraction of patrons and props that only appear '
+                      'for a single lap.')
+  parser.add_argument('--laps', type=int, default=4,
+                      help='Lap-gated entities appear in one of this many '
+                      'laps.')
+  parser.add_argument('--river_zones', type=int, default=0,
+                      help='Number of river zones. Defaults to the endless '
+                      'level\'s zones repeated once per copy.')
+  parser.add_argument('--seed', type=int, default=1,
+                      help='Seed for the placement of duplicated entities.')
+  parser.add_argument('--no_streaming', dest='streaming',
+                      action='store_false',
+                      help='Load every patron and prop when the level loads, '
+                      'instead of streaming them in along the rail.')
+  parser.add_argument('--keep_json', action='store_true',
+                      help='Keep the intermediate JSON files.')
+  args = parser.parse_args()
+
+  try:
+    for scale in args.scale:
+      if scale < 1:
+        raise GeneratorError('Scale must be at least 1.')
+      generate(args, scale)
+  except (GeneratorError, IOError, OSError) as error:
+    sys.stderr.write('%s\n' % str(error))
+    return 1
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -18,7 +18,6 @@
 
 #include "firebase/app.h"
 #include "firebase/future.h"
-#include "firebase/remote_config.h"
 
 #include "mathfu/internal/disable_warnings_end.h"
 
@@ -69,7 +68,9 @@ void AdMobHelper::InitializeCompletion(
   }
 }
 
-void AdMobHelper::Initialize(const firebase::App& app) {
+void AdMobHelper::Initialize(const firebase::App& app,
+                             const RemoteConfig* remote_config) {
+  remote_config_ = remote_config;
   firebase::admob::Initialize(app, kAdMobAppID);
   rewarded_video_status_ = kAdMobStatusInitializing;
   rewarded_video::Initialize().OnCompletion(InitializeCompletion,
@@ -146,9 +147,8 @@ bool AdMobHelper::CheckShowRewardedVideo() {
   }
 }
 
-RewardedVideoLocation AdMobHelper::GetRewardedVideoLocation() {
-  auto location =
-      firebase::remote_config::GetLong(kConfigRewardedVideoLocation);
+RewardedVideoLocation AdMobHelper::GetRewardedVideoLocation() const {
+  auto location = remote_config_->rewarded_video_location();
   if (location < 0 || location >= kRewardedVideoLocationCount) {
     location = 0;
   }
@@ -28,6 +28,7 @@
 namespace fpl {
 namespace zooshi {
 
+class RemoteConfig;
 struct World;
 
 enum AdMobStatus {
@@ -81,9 +82,11 @@ class RewardedVideoListener : public firebase::admob::rewarded_video::Listener {
 
 class AdMobHelper {
  public:
+  AdMobHelper() : remote_config_(nullptr) {}
   ~AdMobHelper();
 
-  void Initialize(const firebase::App& app);
+  // `remote_config` supplies the rewarded video location.
+  void Initialize(const firebase::App& app, const RemoteConfig* remote_config);
 
   void LoadNewRewardedVideo();
 
@@ -99,7 +102,7 @@ class AdMobHelper {
 
   void ResetRewardedVideo() { listener_.Reset(); }
 
-  RewardedVideoLocation GetRewardedVideoLocation();
+  RewardedVideoLocation GetRewardedVideoLocation() const;
 
   float reward_value() { return listener_.reward_item().amount; }
 
@@ -113,6 +116,7 @@ class AdMobHelper {
 
   RewardedVideoListener listener_;
   AdMobStatus rewarded_video_status_;
+  const RemoteConfig* remote_config_;
 };
 
 }  // zooshi
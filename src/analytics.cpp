@@ -41,25 +41,79 @@ const char* kParameterElapsedLevelTime = "elapsed_level_time";
 // Parameter used to track the control scheme being used.
 const char* kParameterControlScheme = "control_scheme";
 
-const char* AnalyticsControlValue(const World* world) {
-  if (world->rendering_mode() == kRenderingStereoscopic) return "VR";
+void RegisterAnalyticsNames(AnalyticsLogger* logger) {
+  static const char* const kNames[] = {
+      kEventPatronFed,
+      kEventGameplayStart,
+      kEventGameplayFinished,
+      kEventMenuSushi,
+      kEventMenuLevel,
+      kEventMenuOptions,
+      kEventMenuSendInvite,
+      firebase::analytics::kEventPostScore,
+      kParameterPatronType,
+      kParameterElapsedLevelTime,
+      kParameterControlScheme,
+      firebase::analytics::kParameterScore,
+      "VR",
+      "gamepad",
+      "onscreen",
+      "default",
+  };
+  static_assert(sizeof(kNames) / sizeof(kNames[0]) == kAnalyticsNameCount,
+                "kNames must match AnalyticsName");
+  for (int i = 0; i < kAnalyticsNameCount; ++i) {
+    const AnalyticsId id = logger->Intern(kNames[i]);
+    (void)id;
+    assert(id == i);
+  }
+}
+
+AnalyticsId AnalyticsControlValue(const World* world) {
+  if (world->rendering_mode() == kRenderingStereoscopic) {
+    return kAnalyticsValueControlVR;
+  }
   if (world->entity_manager
           .GetComponentData<PlayerData>(world->active_player_entity)
           ->input_controller()
           ->controller_type() == kControllerGamepad) {
-    return "gamepad";
+    return kAnalyticsValueControlGamepad;
   }
 #ifdef __ANDROID__
   if (world->onscreen_controller->enabled()) {
-    return "onscreen";
+    return kAnalyticsValueControlOnscreen;
   }
 #endif  // __ANDROID__
-  return "default";
+  return kAnalyticsValueControlDefault;
 }
 
-firebase::analytics::Parameter AnalyticsControlParameter(const World* world) {
-  return firebase::analytics::Parameter(kParameterControlScheme,
-                                        AnalyticsControlValue(world));
+static firebase::analytics::Parameter FirebaseParameter(
+    const AnalyticsParameter& p, const AnalyticsLogger& logger) {
+  const char* name = logger.name(p.name);
+  switch (p.type) {
+    case kAnalyticsValueInt:
+      return firebase::analytics::Parameter(name, p.int_value);
+    case kAnalyticsValueFloat:
+      return firebase::analytics::Parameter(name, p.float_value);
+    default:
+      return firebase::analytics::Parameter(name, logger.name(p.name_value));
+  }
+}
+
+void FirebaseAnalyticsSink::LogEvents(const AnalyticsEvent* events,
+                                      size_t count,
+                                      const AnalyticsLogger& logger) {
+  for (size_t i = 0; i < count; ++i) {
+    const AnalyticsEvent& event = events[i];
+    parameters_.clear();
+    for (int j = 0; j < event.parameter_count; ++j) {
+      parameters_.push_back(FirebaseParameter(event.parameters[j], logger));
+    }
+    const firebase::analytics::Parameter* parameters =
+        parameters_.empty() ? nullptr : &parameters_[0];
+    firebase::analytics::LogEvent(logger.name(event.name), parameters,
+                                  parameters_.size());
+  }
 }
 
 }  // zooshi
@@ -15,6 +15,8 @@
 #ifndef ZOOSHI_ANALYTICS_H_
 #define ZOOSHI_ANALYTICS_H_
 
+#include <vector>
+
 #include "mathfu/internal/disable_warnings_begin.h"
 
 #include "firebase/analytics.h"
@@ -23,6 +25,7 @@
 
 #include "mathfu/internal/disable_warnings_end.h"
 
+#include "analytics_logger.h"
 #include "world.h"
 
 namespace fpl {
@@ -50,10 +53,46 @@ extern const char* kParameterElapsedLevelTime;
 // Parameter used to track the control scheme being used.
 extern const char* kParameterControlScheme;
 
+// The IDs the names above are interned as by RegisterAnalyticsNames(), so
+// that gameplay code can log events without looking anything up.
+enum AnalyticsName {
+  kAnalyticsEventPatronFed,
+  kAnalyticsEventGameplayStart,
+  kAnalyticsEventGameplayFinished,
+  kAnalyticsEventMenuSushi,
+  kAnalyticsEventMenuLevel,
+  kAnalyticsEventMenuOptions,
+  kAnalyticsEventMenuSendInvite,
+  kAnalyticsEventPostScore,
+  kAnalyticsParameterPatronType,
+  kAnalyticsParameterElapsedLevelTime,
+  kAnalyticsParameterControlScheme,
+  kAnalyticsParameterScore,
+  // Values of the control scheme parameter.
+  kAnalyticsValueControlVR,
+  kAnalyticsValueControlGamepad,
+  kAnalyticsValueControlOnscreen,
+  kAnalyticsValueControlDefault,
+  kAnalyticsNameCount
+};
+
+// Intern the names above into `logger`, in order. Must be called before
+// anything else is interned.
+void RegisterAnalyticsNames(AnalyticsLogger* logger);
+
 // Helper function to get the value used with the control scheme parameter.
-const char* AnalyticsControlValue(const World* world);
-// Helper function to create the parameter defining the controller being used.
-firebase::analytics::Parameter AnalyticsControlParameter(const World* world);
+AnalyticsId AnalyticsControlValue(const World* world);
+
+// Delivers events to Firebase Analytics.
+class FirebaseAnalyticsSink : public AnalyticsSink {
+ public:
+  virtual void LogEvents(const AnalyticsEvent* events, size_t count,
+                         const AnalyticsLogger& logger);
+
+ private:
+  // Reused between events to avoid allocating.
+  std::vector<firebase::analytics::Parameter> parameters_;
+};
 
 }  // zooshi
 }  // fpl
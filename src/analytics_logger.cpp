@@ -0,0 +1,205 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "analytics_logger.h"
+
+#include <string.h>
+
+#include "fplbase/utilities.h"
+
+namespace fpl {
+namespace zooshi {
+
+// How often the background thread delivers waiting events, in milliseconds.
+static const uint32_t kDeliveryInterval = 500;
+// The most events handed to the sink in one call.
+static const size_t kMaxBatchSize = 32;
+
+AnalyticsFileSink::AnalyticsFileSink(const std::string& filename)
+    : filename_(filename), file_(nullptr) {}
+
+AnalyticsFileSink::~AnalyticsFileSink() {
+  if (file_ != nullptr) fclose(file_);
+}
+
+void AnalyticsFileSink::LogEvents(const AnalyticsEvent* events, size_t count,
+                                  const AnalyticsLogger& logger) {
+  if (file_ == nullptr) {
+    file_ = fopen(filename_.c_str(), "a");
+    if (file_ == nullptr) {
+      fplbase::LogError("Unable to open analytics log %s", filename_.c_str());
+      return;
+    }
+  }
+  for (size_t i = 0; i < count; ++i) {
+    const AnalyticsEvent& event = events[i];
+    fprintf(file_, "%s", logger.name(event.name));
+    for (int j = 0; j < event.parameter_count; ++j) {
+      const AnalyticsParameter& p = event.parameters[j];
+      switch (p.type) {
+        case kAnalyticsValueInt:
+          fprintf(file_, " %s=%lld", logger.name(p.name),
+                  static_cast<long long>(p.int_value));
+          break;
+        case kAnalyticsValueFloat:
+          fprintf(file_, " %s=%f", logger.name(p.name), p.float_value);
+          break;
+        case kAnalyticsValueName:
+          fprintf(file_, " %s=%s", logger.name(p.name),
+                  logger.name(p.name_value));
+          break;
+      }
+    }
+    fprintf(file_, "\n");
+  }
+  fflush(file_);
+}
+
+AnalyticsLogger::AnalyticsLogger()
+    : dropped_count_(0),
+      name_count_(0),
+      intern_mutex_(SDL_CreateMutex()),
+      sink_(nullptr),
+      mutex_(SDL_CreateMutex()),
+      wake_worker_(SDL_CreateCond()),
+      worker_thread_(nullptr),
+      exiting_(false) {}
+
+AnalyticsLogger::~AnalyticsLogger() {
+  Shutdown();
+  SDL_DestroyCond(wake_worker_);
+  SDL_DestroyMutex(mutex_);
+  SDL_DestroyMutex(intern_mutex_);
+}
+
+void AnalyticsLogger::Initialize(AnalyticsSink* sink) {
+  assert(worker_thread_ == nullptr);
+  sink_ = sink;
+  exiting_ = false;
+  worker_thread_ =
+      SDL_CreateThread(WorkerThread, "Zooshi Analytics Thread", this);
+  if (worker_thread_ == nullptr) {
+    fplbase::LogError("Unable to start analytics thread.");
+  }
+}
+
+void AnalyticsLogger::Shutdown() {
+  if (worker_thread_ == nullptr) return;
+  SDL_LockMutex(mutex_);
+  exiting_ = true;
+  SDL_CondSignal(wake_worker_);
+  SDL_UnlockMutex(mutex_);
+  SDL_WaitThread(worker_thread_, nullptr);
+  worker_thread_ = nullptr;
+}
+
+AnalyticsId AnalyticsLogger::Find(const char* name) const {
+  const size_t count = name_count_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < count; ++i) {
+    if (strcmp(names_[i].c_str(), name) == 0) {
+      return static_cast<AnalyticsId>(i);
+    }
+  }
+  return kInvalidAnalyticsId;
+}
+
+AnalyticsId AnalyticsLogger::Intern(const char* name) {
+  AnalyticsId id = Find(name);
+  if (id != kInvalidAnalyticsId) return id;
+
+  SDL_LockMutex(intern_mutex_);
+  // Someone else may have interned it while we waited for the lock.
+  id = Find(name);
+  if (id == kInvalidAnalyticsId) {
+    const size_t count = name_count_.load(std::memory_order_relaxed);
+    if (count < kMaxNames) {
+      names_[count] = name;
+      name_count_.store(count + 1, std::memory_order_release);
+      id = static_cast<AnalyticsId>(count);
+    } else {
+      fplbase::LogError("Too many analytics names, dropping %s", name);
+    }
+  }
+  SDL_UnlockMutex(intern_mutex_);
+  return id;
+}
+
+// Returns true if every ID `parameter` refers to was interned.
+static bool ParameterIsValid(const AnalyticsParameter& parameter) {
+  return parameter.name != kInvalidAnalyticsId &&
+         (parameter.type != kAnalyticsValueName ||
+          parameter.name_value != kInvalidAnalyticsId);
+}
+
+bool AnalyticsLogger::LogEvent(const AnalyticsEvent& event) {
+  return Push(event, &events_);
+}
+
+bool AnalyticsLogger::LogUiEvent(const AnalyticsEvent& event) {
+  return Push(event, &ui_events_);
+}
+
+bool AnalyticsLogger::Push(const AnalyticsEvent& event, EventQueue* queue) {
+  AnalyticsEvent valid_event(event.name);
+  for (int i = 0; i < event.parameter_count; ++i) {
+    if (ParameterIsValid(event.parameters[i])) {
+      valid_event.parameters[valid_event.parameter_count++] =
+          event.parameters[i];
+    }
+  }
+  if (event.name == kInvalidAnalyticsId || !queue->Push(valid_event)) {
+    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+int AnalyticsLogger::WorkerThread(void* data) {
+  static_cast<AnalyticsLogger*>(data)->WorkerLoop();
+  return 0;
+}
+
+void AnalyticsLogger::WorkerLoop() {
+  SDL_LockMutex(mutex_);
+  while (!exiting_) {
+    // Producers never signal, so that logging stays a few stores; just poll.
+    SDL_CondWaitTimeout(wake_worker_, mutex_, kDeliveryInterval);
+    SDL_UnlockMutex(mutex_);
+    Drain();
+    SDL_LockMutex(mutex_);
+  }
+  SDL_UnlockMutex(mutex_);
+  // Deliver anything logged since the last pass.
+  Drain();
+}
+
+// Events from the two rings are delivered one ring after the other, so their
+// relative order is only kept within a ring.
+void AnalyticsLogger::Drain() {
+  AnalyticsEvent batch[kMaxBatchSize];
+  size_t count = 0;
+  EventQueue* queues[] = {&events_, &ui_events_};
+  for (size_t i = 0; i < sizeof(queues) / sizeof(queues[0]); ++i) {
+    while (queues[i]->Pop(&batch[count])) {
+      if (++count == kMaxBatchSize) {
+        sink_->LogEvents(batch, count, *this);
+        count = 0;
+      }
+    }
+  }
+  if (count > 0) sink_->LogEvents(batch, count, *this);
+}
+
+}  // zooshi
+}  // fpl
@@ -0,0 +1,200 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_ANALYTICS_LOGGER_H_
+#define ZOOSHI_ANALYTICS_LOGGER_H_
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <string>
+
+#include "SDL_thread.h"
+#include "spsc_queue.h"
+
+namespace fpl {
+namespace zooshi {
+
+// Event and parameter names, and string parameter values, are passed around
+// as small integers interned by an AnalyticsLogger.
+typedef uint16_t AnalyticsId;
+const AnalyticsId kInvalidAnalyticsId = 0xFFFF;
+
+// The most parameters a single event can carry.
+const int kMaxAnalyticsParameters = 3;
+
+enum AnalyticsValueType {
+  kAnalyticsValueInt,
+  kAnalyticsValueFloat,
+  // An interned string, e.g. the name of a control scheme.
+  kAnalyticsValueName,
+};
+
+struct AnalyticsParameter {
+  AnalyticsId name;
+  uint8_t type;
+  union {
+    int64_t int_value;
+    double float_value;
+    AnalyticsId name_value;
+  };
+};
+
+// A compact, fixed-size record of one event. Building one is just a handful
+// of stores, so it is cheap to do from gameplay code.
+struct AnalyticsEvent {
+  AnalyticsEvent() : name(kInvalidAnalyticsId), parameter_count(0) {}
+  explicit AnalyticsEvent(AnalyticsId event_name)
+      : name(event_name), parameter_count(0) {}
+
+  AnalyticsEvent& AddInt(AnalyticsId parameter, int64_t value) {
+    AnalyticsParameter& p = Add(parameter, kAnalyticsValueInt);
+    p.int_value = value;
+    return *this;
+  }
+  AnalyticsEvent& AddFloat(AnalyticsId parameter, double value) {
+    AnalyticsParameter& p = Add(parameter, kAnalyticsValueFloat);
+    p.float_value = value;
+    return *this;
+  }
+  AnalyticsEvent& AddName(AnalyticsId parameter, AnalyticsId value) {
+    AnalyticsParameter& p = Add(parameter, kAnalyticsValueName);
+    p.name_value = value;
+    return *this;
+  }
+
+  AnalyticsId name;
+  uint8_t parameter_count;
+  AnalyticsParameter parameters[kMaxAnalyticsParameters];
+
+ private:
+  AnalyticsParameter& Add(AnalyticsId parameter, AnalyticsValueType type) {
+    assert(parameter_count < kMaxAnalyticsParameters);
+    AnalyticsParameter& p = parameters[parameter_count++];
+    p.name = parameter;
+    p.type = static_cast<uint8_t>(type);
+    return p;
+  }
+};
+
+class AnalyticsLogger;
+
+// Where an AnalyticsLogger delivers its events.
+class AnalyticsSink {
+ public:
+  virtual ~AnalyticsSink() {}
+
+  // Called on the logger's thread with a batch of events, oldest first.
+  // `logger` resolves their interned names.
+  virtual void LogEvents(const AnalyticsEvent* events, size_t count,
+                         const AnalyticsLogger& logger) = 0;
+};
+
+// Appends each event to a local text file, one per line. A stand-in for the
+// real analytics service when testing.
+class AnalyticsFileSink : public AnalyticsSink {
+ public:
+  explicit AnalyticsFileSink(const std::string& filename);
+  virtual ~AnalyticsFileSink();
+
+  virtual void LogEvents(const AnalyticsEvent* events, size_t count,
+                         const AnalyticsLogger& logger);
+
+ private:
+  std::string filename_;
+  FILE* file_;
+};
+
+// Takes analytics events off the gameplay thread. LogEvent() copies the
+// record into a single-producer/single-consumer ring; a background thread
+// wakes up every so often, drains the ring and hands the events to the sink
+// in one batch.
+//
+// Each ring has one producer. LogEvent() must only be called with the game
+// update mutex held, i.e. from a state's AdvanceFrame() or Render() or from
+// a component. HandleUI() runs on the render thread without the mutex, so it
+// logs through LogUiEvent(), which has a ring of its own.
+class AnalyticsLogger {
+ public:
+  // The most events that can be waiting at once.
+  static const size_t kMaxEvents = 256;
+  // The most distinct names that can be interned.
+  static const size_t kMaxNames = 128;
+
+  AnalyticsLogger();
+  ~AnalyticsLogger();
+
+  // Start delivering events to `sink`, which must outlive the logger or the
+  // next call to Shutdown().
+  void Initialize(AnalyticsSink* sink);
+
+  // Deliver any waiting events, then stop the background thread.
+  void Shutdown();
+
+  // Returns the ID for `name`, interning it if it is new. Finding an existing
+  // name is lock-free; interning a new one takes a lock. Returns
+  // kInvalidAnalyticsId if the table is full.
+  AnalyticsId Intern(const char* name);
+
+  // The name an ID was interned from, or an empty string if `id` was never
+  // interned.
+  const char* name(AnalyticsId id) const {
+    return id < name_count_.load(std::memory_order_acquire)
+               ? names_[id].c_str()
+               : "";
+  }
+
+  // Queue an event. Parameters whose name or value failed to intern are left
+  // out. Returns false, dropping the event, if the event's own name is
+  // invalid or the ring is full.
+  bool LogEvent(const AnalyticsEvent& event);
+
+  // Queue an event from a state's HandleUI(). Same as LogEvent() otherwise.
+  bool LogUiEvent(const AnalyticsEvent& event);
+
+  // The number of events dropped because the ring was full.
+  uint32_t dropped_count() const {
+    return dropped_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  typedef SpscQueue<AnalyticsEvent, kMaxEvents> EventQueue;
+
+  bool Push(const AnalyticsEvent& event, EventQueue* queue);
+  static int WorkerThread(void* data);
+  void WorkerLoop();
+  // Hand everything in the ring to the sink.
+  void Drain();
+  AnalyticsId Find(const char* name) const;
+
+  EventQueue events_;
+  EventQueue ui_events_;
+  std::atomic<uint32_t> dropped_count_;
+
+  std::string names_[kMaxNames];
+  std::atomic<size_t> name_count_;
+  SDL_mutex* intern_mutex_;
+
+  AnalyticsSink* sink_;
+  SDL_mutex* mutex_;
+  SDL_cond* wake_worker_;
+  SDL_Thread* worker_thread_;
+  bool exiting_;
+};
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_ANALYTICS_LOGGER_H_
@@ -0,0 +1,179 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures how fast incoming multiplayer messages can be handed from the
+// thread that receives them to the game thread.
+//
+// A loopback transport stands in for the Nearby Connections backend: a
+// thread that delivers prebuilt payloads from a handful of fake instances
+// through the same callback signature GPGMultiplayer's MessageListener uses.
+// Each run compares the mutex-guarded std::queue GPGMultiplayer used to keep
+// with MultiplayerMessageQueue.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "multiplayer_message_queue.h"
+
+namespace fpl {
+
+typedef std::function<bool(const std::string&, const std::vector<uint8_t>&,
+                           bool)> ReceiveCallback;
+
+// Delivers `message_count` messages of `payload_size` bytes on its own
+// thread, round-robin from `instance_count` senders. The callback returns
+// false if it could not take a message, in which case it is offered again,
+// like a transport applying back pressure.
+class LoopbackTransport {
+ public:
+  LoopbackTransport(int instance_count, size_t payload_size)
+      : payloads_(instance_count) {
+    for (int i = 0; i < instance_count; ++i) {
+      instance_ids_.push_back("loopback-instance-" + std::to_string(i));
+      payloads_[i].resize(payload_size, static_cast<uint8_t>(i + 1));
+    }
+  }
+
+  void Start(int message_count, const ReceiveCallback& receive) {
+    thread_ = std::thread([this, message_count, receive]() {
+      const size_t instance_count = instance_ids_.size();
+      for (int i = 0; i < message_count; ++i) {
+        const size_t instance = i % instance_count;
+        while (!receive(instance_ids_[instance], payloads_[instance],
+                        (i & 1) != 0)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  void Join() { thread_.join(); }
+
+ private:
+  std::vector<std::string> instance_ids_;
+  std::vector<std::vector<uint8_t>> payloads_;
+  std::thread thread_;
+};
+
+struct RunResult {
+  double seconds;
+  uint64_t checksum;
+};
+
+// The original GPGMultiplayer receive path: copy the sender and payload into
+// a mutex-guarded queue, then copy them out again when draining.
+static RunResult RunLockedQueue(int instance_count, size_t payload_size,
+                                int message_count) {
+  typedef std::pair<std::string, std::vector<uint8_t>> SenderAndMessage;
+  std::queue<SenderAndMessage> messages;
+  std::mutex mutex;
+  LoopbackTransport transport(instance_count, payload_size);
+
+  const auto start = std::chrono::steady_clock::now();
+  transport.Start(message_count,
+                  [&](const std::string& instance_id,
+                      const std::vector<uint8_t>& payload, bool /*reliable*/) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    messages.push({instance_id, payload});
+                    return true;
+                  });
+  RunResult result = {0.0, 0};
+  for (int received = 0; received < message_count;) {
+    SenderAndMessage message;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!messages.empty()) {
+        message = messages.front();
+        messages.pop();
+      }
+    }
+    if (message.second.empty()) {
+      std::this_thread::yield();
+      continue;
+    }
+    result.checksum += message.first.size() + message.second[0];
+    ++received;
+  }
+  transport.Join();
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+static RunResult RunMessageQueue(int instance_count, size_t payload_size,
+                                 int message_count) {
+  MultiplayerMessageQueue messages;
+  LoopbackTransport transport(instance_count, payload_size);
+
+  const auto start = std::chrono::steady_clock::now();
+  transport.Start(message_count,
+                  [&](const std::string& instance_id,
+                      const std::vector<uint8_t>& payload, bool reliable) {
+                    const MultiplayerMessageQueue::InstanceHandle sender =
+                        messages.InternInstanceId(instance_id);
+                    return messages.Push(sender, payload.data(),
+                                         payload.size(), reliable);
+                  });
+  RunResult result = {0.0, 0};
+  for (int received = 0; received < message_count;) {
+    MultiplayerMessageQueue::Message message;
+    if (!messages.Pop(&message)) {
+      std::this_thread::yield();
+      continue;
+    }
+    result.checksum +=
+        messages.instance_id(message.sender).size() + message.payload[0];
+    ++received;
+  }
+  transport.Join();
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+static void Report(const char* name, size_t payload_size, int message_count,
+                   const RunResult& result) {
+  const double messages_per_second = message_count / result.seconds;
+  printf("%-24s %6u bytes  %10.0f msg/s  %8.1f MB/s  (checksum %llu)\n", name,
+         static_cast<unsigned int>(payload_size), messages_per_second,
+         messages_per_second * payload_size / (1024.0 * 1024.0),
+         static_cast<unsigned long long>(result.checksum));
+}
+
+}  // namespace fpl
+
+int main() {
+  static const int kInstanceCount = 4;
+  static const int kMessageCount = 500000;
+  static const size_t kPayloadSizes[] = {16, 256, 1024, 4096};
+
+  for (size_t i = 0; i < sizeof(kPayloadSizes) / sizeof(kPayloadSizes[0]);
+       ++i) {
+    const size_t payload_size = kPayloadSizes[i];
+    fpl::Report("mutex + std::queue", payload_size, kMessageCount,
+                fpl::RunLockedQueue(kInstanceCount, payload_size,
+                                    kMessageCount));
+    fpl::Report("MultiplayerMessageQueue", payload_size, kMessageCount,
+                fpl::RunMessageQueue(kInstanceCount, payload_size,
+                                     kMessageCount));
+  }
+  return 0;
+}
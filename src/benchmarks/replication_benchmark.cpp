@@ -0,0 +1,177 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs two replication sessions against each other over a lossy in-process
+// loopback transport, with a synthetic game standing in for the real one.
+// Checks that the client ends up with exactly the host's state and every
+// projectile spawn exactly once, and reports the bandwidth used with delta
+// encoding against the bandwidth of sending full snapshots. Exits with a
+// non-zero status if either check fails.
+
+#include <math.h>
+#include <stdio.h>
+#include <map>
+
+#include "mathfu/constants.h"
+#include "replication.h"
+
+namespace fpl {
+namespace zooshi {
+
+static const int kTicksPerSecond = 30;
+static const int kSeconds = 60;
+static const int kPatronCount = 24;
+static const float kLossRate = 0.1f;
+
+// A stand-in for the game: the raft goes round in a circle, patrons stand up
+// as it approaches and fall down once it has passed, and sushi is thrown a
+// couple of times a second.
+static void SimulateTick(int tick, ReplicationSnapshot* snapshot,
+                         ReplicationSession* session) {
+  const float seconds = static_cast<float>(tick) / kTicksPerSecond;
+  const float lap_progress = seconds / 20.0f;
+  const float angle = lap_progress * 6.2831853f;
+  snapshot->raft.lap_number = static_cast<int32_t>(lap_progress);
+  snapshot->raft.total_lap_progress = lap_progress;
+  snapshot->raft.position = QuantizeVec3(
+      mathfu::vec3(cosf(angle), sinf(angle), 0.0f) * 100.0f,
+      kReplicatedPositionScale);
+  snapshot->raft.orientation = QuantizeQuat(
+      mathfu::quat::FromAngleAxis(angle, mathfu::kAxisZ3f));
+
+  snapshot->patrons.resize(kPatronCount);
+  for (int i = 0; i < kPatronCount; ++i) {
+    const float patron_progress = static_cast<float>(i) / kPatronCount;
+    float behind = lap_progress - static_cast<int>(lap_progress) -
+                   patron_progress;
+    if (behind < 0.0f) behind += 1.0f;
+    PatronSnapshot& patron = snapshot->patrons[i];
+    patron.state = behind > 0.95f ? 1 : behind < 0.05f ? 2 : 0;
+    const float patron_angle = patron_progress * 6.2831853f;
+    patron.position = QuantizeVec3(
+        mathfu::vec3(cosf(patron_angle), sinf(patron_angle), 0.0f) * 120.0f,
+        kReplicatedPositionScale);
+    patron.orientation = QuantizeQuat(
+        mathfu::quat::FromAngleAxis(patron_angle, mathfu::kAxisZ3f));
+  }
+
+  if (tick % 13 == 0) {
+    session->AddProjectileSpawn(ProjectileSpawn(
+        0, 0, snapshot->raft.position,
+        QuantizeVec3(mathfu::vec3(0.0f, 40.0f, 7.5f),
+                     kReplicatedVelocityScale),
+        snapshot->raft.orientation));
+  }
+}
+
+static bool SnapshotsEqual(const ReplicationSnapshot& a,
+                           const ReplicationSnapshot& b) {
+  if (!(a.raft == b.raft) || a.patrons.size() != b.patrons.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.patrons.size(); ++i) {
+    if (!(a.patrons[i] == b.patrons[i])) return false;
+  }
+  return true;
+}
+
+// Returns the host's average upstream bytes per second. If `acknowledge` is
+// false the client never sends anything back, so the host can only ever send
+// full snapshots. Every mismatch between what was sent and what was received
+// is reported and counted in `errors`.
+static uint32_t Run(bool acknowledge, int* errors) {
+  LoopbackReplicationTransport host_transport;
+  LoopbackReplicationTransport client_transport;
+  LoopbackReplicationTransport::Connect(&host_transport, &client_transport);
+  host_transport.set_loss_rate(kLossRate);
+  client_transport.set_loss_rate(kLossRate);
+  ReplicationSession host(&host_transport);
+  ReplicationSession client(&client_transport);
+
+  std::map<uint32_t, ReplicationSnapshot> sent;
+  int spawns_sent = 0;
+  uint32_t bytes_per_second_total = 0;
+  int seconds_measured = 0;
+  const int tick_count = kSeconds * kTicksPerSecond;
+  for (int tick = 1; tick <= tick_count; ++tick) {
+    if (tick % 13 == 0) ++spawns_sent;
+    SimulateTick(tick, host.local_snapshot(), &host);
+    const uint32_t time = static_cast<uint32_t>(tick * 1000 / kTicksPerSecond);
+    host.Tick(time);
+    sent[host.local_snapshot()->tick] = *host.local_snapshot();
+    if (tick % kTicksPerSecond == 0) {
+      bytes_per_second_total += host.bytes_sent_per_second();
+      ++seconds_measured;
+    }
+
+    client.ReceivePackets();
+    if (acknowledge) client.Tick(time);
+    host.ReceivePackets();
+
+    // Whatever the client has decoded must match what the host sent.
+    const ReplicationSnapshot& received = client.peer_snapshot(0);
+    if (received.tick != 0 &&
+        !SnapshotsEqual(received, sent[received.tick])) {
+      fprintf(stderr, "  tick %d: client snapshot %u differs from the host's\n",
+              tick, received.tick);
+      ++*errors;
+    }
+  }
+
+  // Let the last spawns get through.
+  for (int tick = 0; tick < 10; ++tick) {
+    host.Tick(0);
+    client.ReceivePackets();
+    if (acknowledge) client.Tick(0);
+    host.ReceivePackets();
+  }
+  std::vector<std::pair<int, ProjectileSpawn>>* spawns =
+      client.received_spawns();
+  printf("  spawns: %d sent, %d received\n", spawns_sent,
+         static_cast<int>(spawns->size()));
+  if (static_cast<int>(spawns->size()) != spawns_sent) {
+    fprintf(stderr, "  spawns were lost or duplicated\n");
+    ++*errors;
+  }
+  for (size_t i = 0; i < spawns->size(); ++i) {
+    if ((*spawns)[i].second.id() != i + 1) {
+      fprintf(stderr, "  spawn %d has id %d\n", static_cast<int>(i),
+              static_cast<int>((*spawns)[i].second.id()));
+      ++*errors;
+    }
+  }
+
+  return bytes_per_second_total / seconds_measured;
+}
+
+}  // zooshi
+}  // fpl
+
+int main() {
+  printf("%d patrons, %d ticks/s, %.0f%% packet loss\n",
+         fpl::zooshi::kPatronCount, fpl::zooshi::kTicksPerSecond,
+         fpl::zooshi::kLossRate * 100.0f);
+  printf("full snapshots:\n");
+  int errors = 0;
+  const uint32_t full = fpl::zooshi::Run(false, &errors);
+  printf("  %u bytes/s\n", full);
+  printf("delta encoded:\n");
+  const uint32_t delta = fpl::zooshi::Run(true, &errors);
+  printf("  %u bytes/s (%.1f%% of full)\n", delta, 100.0f * delta / full);
+  if (errors > 0) {
+    fprintf(stderr, "%d replication errors\n", errors);
+    return 1;
+  }
+  return 0;
+}
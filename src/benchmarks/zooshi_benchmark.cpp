@@ -0,0 +1,672 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks for the game's hot functions. Rails and rivers are built
+// from the shipped levels, and the world benchmarks load each level into a
+// World the way the game does; everything else uses synthetic fixtures
+// generated from fixed seeds, so results can be compared between runs and
+// machines. The world benchmarks open a small window, since the asset manager
+// needs a GL context; the rest never touch the GPU.
+//
+// Usage: zooshi_benchmark [assets_directory] [name_filter] [overlay]
+//
+// Only benchmarks whose name contains `name_filter` are run. Files are looked
+// up in assets_directory/overlays/`overlay` first, as the game does, so the
+// stress levels from scripts/generate_stress_level.py can be benchmarked.
+// Each result is printed on its own line as a JSON object:
+//   {"name": "...", "params": "...", "iterations": N, "ns_per_op": X,
+//    "checksum": C}
+// The checksum depends only on the fixture, so a change in it means the
+// benchmark is measuring different work.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif  // _WIN32
+#include <chrono>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "assets_generated.h"
+#include "breadboard/modules/common.h"
+#include "components/patron.h"
+#include "components/rail_denizen.h"
+#include "components/river.h"
+#include "components_generated.h"
+#include "config_generated.h"
+#include "flatbuffers/flatbuffers.h"
+#include "flatui/font_manager.h"
+#include "fplbase/asset_manager.h"
+#include "fplbase/flatbuffer_utils.h"
+#include "fplbase/input.h"
+#include "fplbase/renderer.h"
+#include "fplbase/utilities.h"
+#include "frame_arena.h"
+#include "gpg_manager.h"
+#include "input_config_generated.h"
+#include "inputcontrollers/mouse_controller.h"
+#include "mathfu/utilities.h"
+#include "module_library/animation.h"
+#include "module_library/audio.h"
+#include "module_library/default_graph_factory.h"
+#include "module_library/entity.h"
+#include "module_library/physics.h"
+#include "module_library/rendermesh.h"
+#include "module_library/transform.h"
+#include "module_library/vec.h"
+#include "modules/attributes.h"
+#include "modules/gpg.h"
+#include "modules/patron.h"
+#include "modules/player.h"
+#include "modules/rail_denizen.h"
+#include "modules/state.h"
+#include "modules/ui_string.h"
+#include "modules/zooshi.h"
+#include "pindrop/pindrop.h"
+#include "railmanager.h"
+#include "world.h"
+#include "world_renderer.h"
+
+using mathfu::vec3;
+using mathfu::vec3_packed;
+
+namespace fpl {
+namespace zooshi {
+
+// Each benchmark runs for at least this long.
+static const double kMinBenchmarkSeconds = 0.25;
+static const uint32_t kRandomSeed = 1;
+// Same as the granularity RailManager builds rails with.
+static const float kSplineGranularity = 10.0f;
+static const float kGravity = -30.0f;
+static const float kTwoPi = 6.2831853f;
+static const char kConfigFileName[] = "config.zooconfig";
+// One frame at 60Hz, in the milliseconds the components are updated with.
+static const corgi::WorldTime kFrameTime = 16;
+static const int kWindowWidth = 320;
+static const int kWindowHeight = 240;
+
+static const char* g_filter = "";
+static std::string g_overlay;
+
+// Uses the raw generator output rather than std::uniform_real_distribution,
+// whose results differ between standard libraries.
+static float RandomInRange(std::mt19937* rng, float min, float max) {
+  const float unit = static_cast<float>((*rng)()) / 4294967296.0f;
+  return min + (max - min) * unit;
+}
+
+// Calls `op` until kMinBenchmarkSeconds have passed and prints the time per
+// call. `op` returns a value that is folded into the checksum so the work
+// can't be optimized away.
+template <typename Op>
+static void RunBenchmark(const char* name, const std::string& params, Op op) {
+  if (strstr(name, g_filter) == nullptr) return;
+  typedef std::chrono::steady_clock Clock;
+  uint64_t checksum = op();
+  uint64_t iterations = 0;
+  uint64_t batch = 1;
+  double seconds = 0.0;
+  while (seconds < kMinBenchmarkSeconds) {
+    const Clock::time_point start = Clock::now();
+    for (uint64_t i = 0; i < batch; ++i) {
+      const uint64_t result = op();
+      if (result != checksum) {
+        fprintf(stderr, "%s (%s): result changed between runs\n", name,
+                params.c_str());
+      }
+    }
+    seconds += std::chrono::duration<double>(Clock::now() - start).count();
+    iterations += batch;
+    batch *= 2;
+  }
+  printf("{\"name\": \"%s\", \"params\": \"%s\", \"iterations\": %llu, "
+         "\"ns_per_op\": %.1f, \"checksum\": %llu}\n",
+         name, params.c_str(), static_cast<unsigned long long>(iterations),
+         seconds * 1e9 / static_cast<double>(iterations),
+         static_cast<unsigned long long>(checksum));
+  fflush(stdout);
+}
+
+static uint64_t HashFloat(uint64_t hash, float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return hash * 31 + bits;
+}
+
+// PatronComponent::ClosestProjectile: `num_patrons` patrons in a ring around
+// the raft, each searching `num_projectiles` sushi thrown in random
+// directions. One op is one frame's worth of searches.
+static void BenchmarkClosestProjectile(int num_patrons, int num_projectiles) {
+  std::mt19937 rng(kRandomSeed);
+  // CatchQuery holds SIMD vectors, so needs an aligned allocator.
+  std::vector<CatchQuery, mathfu::simd_allocator<CatchQuery>> queries(
+      num_patrons);
+  for (int i = 0; i < num_patrons; ++i) {
+    const float angle = RandomInRange(&rng, 0.0f, kTwoPi);
+    const float radius = RandomInRange(&rng, 8.0f, 40.0f);
+    CatchQuery& query = queries[i];
+    query.patron_position_xy =
+        vec3(cosf(angle) * radius, sinf(angle) * radius, 0.0f);
+    query.return_position_xy = query.patron_position_xy;
+    query.raft_position_xy = mathfu::kZeros3f;
+    query.target_height_range = motive::Range(1.0f, 3.0f);
+    query.catch_time_for_search = motive::Range(0.01f, 4.0f);
+    query.max_catch_distance_for_search = 12.0f;
+    query.max_catch_angle = 120.0f;
+    query.returning = (i % 4) == 0;
+  }
+  std::vector<CatchCandidate> candidates(num_projectiles);
+  for (int i = 0; i < num_projectiles; ++i) {
+    const float angle = RandomInRange(&rng, 0.0f, kTwoPi);
+    const float speed = RandomInRange(&rng, 15.0f, 40.0f);
+    CatchCandidate& candidate = candidates[i];
+    candidate.position = vec3(RandomInRange(&rng, -10.0f, 10.0f),
+                              RandomInRange(&rng, -10.0f, 10.0f),
+                              RandomInRange(&rng, 2.0f, 4.0f));
+    candidate.velocity = vec3(cosf(angle) * speed, sinf(angle) * speed,
+                              RandomInRange(&rng, 5.0f, 10.0f));
+    candidate.gravity = kGravity;
+  }
+
+  RunBenchmark("closest_projectile",
+               "patrons=" + std::to_string(num_patrons) +
+                   " projectiles=" + std::to_string(num_projectiles),
+               [&]() {
+                 uint64_t hash = 0;
+                 for (size_t i = 0; i < queries.size(); ++i) {
+                   CatchIntercept intercept;
+                   const int index =
+                       FindClosestCatch(queries[i], candidates.data(),
+                                        candidates.size(), &intercept);
+                   hash = hash * 31 + static_cast<uint64_t>(index + 1);
+                 }
+                 return hash;
+               });
+}
+
+// The parts of a RailNodeDef that RailManager::GetRailFromComponents uses.
+struct RailNodeFixture {
+  RailNodeFixture() : total_time(-1), reliable_distance(-1), wraps(true) {}
+  vec3_packed position;
+  float total_time;
+  float reliable_distance;
+  bool wraps;
+};
+
+// A rail, and the node positions and parameters it was built from.
+struct RailFixture {
+  std::vector<vec3_packed> positions;
+  RailNodeFixture params;
+  Rail rail;
+};
+
+// The rails and river declared by one level's entity files.
+struct LevelFixture {
+  std::string name;
+  const RiverConfig* river_config;
+  std::string river_rail_name;
+  std::map<std::string, std::unique_ptr<RailFixture>> rails;
+};
+
+typedef std::map<std::string, std::map<float, RailNodeFixture>> RailNodeMap;
+
+// Installed as fplbase's load file function, so that everything the World
+// loads is looked up in the overlay first, as Game::LoadFile does. Paths are
+// relative to the assets directory, which RunBenchmarks changes into.
+static bool LoadOverlayFile(const char* filename, std::string* dest) {
+  if (!g_overlay.empty()) {
+    const std::string overlay = "overlays/" + g_overlay + "/" + filename;
+    FILE* file = fopen(overlay.c_str(), "rb");
+    if (file) {
+      fclose(file);
+      return fplbase::LoadFileRaw(overlay.c_str(), dest);
+    }
+  }
+  return fplbase::LoadFileRaw(filename, dest);
+}
+
+static bool LoadAssetFile(const char* name, std::string* contents) {
+  if (!fplbase::LoadFile(name, contents)) {
+    fprintf(stderr, "Can't load %s\n", name);
+    return false;
+  }
+  return true;
+}
+
+// Collects the rail nodes and river from an entity file, the same way the
+// RailNode and River components would when the level is loaded.
+static bool LoadEntityFile(const char* filename, RailNodeMap* rail_nodes,
+                           std::string* river_rail) {
+  std::string source;
+  if (!LoadAssetFile(filename, &source)) return false;
+  const EntityListDef* entity_list = GetEntityListDef(source.c_str());
+  for (auto entity = entity_list->entity_list()->begin();
+       entity != entity_list->entity_list()->end(); ++entity) {
+    const RailNodeDef* rail_node_def = nullptr;
+    const corgi::TransformDef* transform_def = nullptr;
+    for (auto component = entity->component_list()->begin();
+         component != entity->component_list()->end(); ++component) {
+      switch (component->data_type()) {
+        case ComponentDataUnion_RailNodeDef:
+          rail_node_def = static_cast<const RailNodeDef*>(component->data());
+          break;
+        case ComponentDataUnion_corgi_TransformDef:
+          transform_def =
+              static_cast<const corgi::TransformDef*>(component->data());
+          break;
+        case ComponentDataUnion_RiverDef:
+          *river_rail = static_cast<const RiverDef*>(component->data())
+                            ->rail_name()
+                            ->c_str();
+          break;
+        default:
+          break;
+      }
+    }
+    if (rail_node_def == nullptr || transform_def == nullptr) continue;
+
+    RailNodeFixture node;
+    node.position = LoadVec3(transform_def->position());
+    if (rail_node_def->total_time()) {
+      node.total_time = rail_node_def->total_time();
+    }
+    if (rail_node_def->reliable_distance()) {
+      node.reliable_distance = rail_node_def->reliable_distance();
+    }
+    node.wraps = rail_node_def->wraps();
+    (*rail_nodes)[rail_node_def->rail_name()->c_str()]
+                 [rail_node_def->ordering()] = node;
+  }
+  return true;
+}
+
+static bool LoadLevels(std::string* config_source,
+                       std::vector<std::unique_ptr<LevelFixture>>* levels) {
+  if (!LoadAssetFile(kConfigFileName, config_source)) return false;
+  const WorldDef* world_def = GetConfig(config_source->c_str())->world_def();
+  for (auto level_def = world_def->levels()->begin();
+       level_def != world_def->levels()->end(); ++level_def) {
+    std::unique_ptr<LevelFixture> level(new LevelFixture());
+    level->name = level_def->name()->c_str();
+    level->river_config = level_def->river_config();
+
+    RailNodeMap rail_nodes;
+    for (auto file = world_def->entity_files()->begin();
+         file != world_def->entity_files()->end(); ++file) {
+      if (!LoadEntityFile(file->c_str(), &rail_nodes,
+                          &level->river_rail_name)) {
+        return false;
+      }
+    }
+    for (auto file = level_def->entity_files()->begin();
+         file != level_def->entity_files()->end(); ++file) {
+      if (!LoadEntityFile(file->c_str(), &rail_nodes,
+                          &level->river_rail_name)) {
+        return false;
+      }
+    }
+
+    // Build each rail as RailManager::GetRailFromComponents does.
+    for (auto it = rail_nodes.begin(); it != rail_nodes.end(); ++it) {
+      RailFixture* fixture = new RailFixture();
+      level->rails[it->first].reset(fixture);
+      fixture->params = it->second.begin()->second;
+      for (auto node = it->second.begin(); node != it->second.end(); ++node) {
+        fixture->positions.push_back(node->second.position);
+      }
+      if (fixture->params.wraps) {
+        fixture->positions.push_back(fixture->positions[0]);
+      }
+      fixture->rail.InitializeFromPositions(
+          fixture->positions.data(), fixture->positions.size(),
+          kSplineGranularity, fixture->params.reliable_distance,
+          fixture->params.total_time, fixture->params.wraps);
+    }
+    levels->push_back(std::move(level));
+  }
+  return true;
+}
+
+// Rail::InitializeFromPositions, Rail::Positions and
+// Rail::PositionCalculatedSlowly on every rail of a level. The rails are
+// sampled at the river's step size, as CreateRiverMesh does.
+static void BenchmarkRails(const LevelFixture& level) {
+  FrameArena arena;
+  FrameArena::SetCurrent(&arena);
+  const float step = level.river_config->spline_stepsize();
+  for (auto it = level.rails.begin(); it != level.rails.end(); ++it) {
+    const RailFixture& fixture = *it->second;
+    const Rail& rail = fixture.rail;
+    const std::vector<vec3_packed>& nodes = fixture.positions;
+    const size_t num_samples =
+        static_cast<size_t>(std::floor(rail.EndTime() / step)) + 1;
+    const std::string params = "level=" + level.name + " rail=" + it->first +
+                               " nodes=" + std::to_string(nodes.size()) +
+                               " samples=" + std::to_string(num_samples);
+
+    RunBenchmark("rail_initialize", params, [&]() {
+      Rail new_rail;
+      new_rail.InitializeFromPositions(
+          nodes.data(), nodes.size(), kSplineGranularity,
+          fixture.params.reliable_distance, fixture.params.total_time,
+          fixture.params.wraps);
+      arena.Reset();
+      return static_cast<uint64_t>(new_rail.MemoryBytes());
+    });
+
+    RunBenchmark("rail_positions", params, [&]() {
+      uint64_t hash = 0;
+      {
+        FrameVector<vec3_packed> track;
+        rail.Positions(step, &track);
+        hash = HashFloat(track.size(), track.back().x);
+      }
+      arena.Reset();
+      return hash;
+    });
+
+    RunBenchmark("rail_position_calculated_slowly", params, [&]() {
+      uint64_t hash = 0;
+      for (size_t i = 0; i < num_samples; ++i) {
+        const vec3 position =
+            rail.PositionCalculatedSlowly(static_cast<float>(i) * step);
+        hash = HashFloat(hash, position.x);
+      }
+      return hash;
+    });
+  }
+  FrameArena::SetCurrent(nullptr);
+}
+
+// The CPU half of RiverComponent::CreateRiverMesh, on the level's real
+// river rail. Bank materials aren't loaded, so every zone is treated as
+// blended; that only changes the vertex colors.
+static void BenchmarkRiverGeometry(const LevelFixture& level) {
+  auto fixture = level.rails.find(level.river_rail_name);
+  if (fixture == level.rails.end()) return;
+  const Rail& rail = fixture->second->rail;
+  const RiverConfig& river = *level.river_config;
+  FrameArena arena;
+  FrameArena::SetCurrent(&arena);
+  RunBenchmark("river_geometry", "level=" + level.name, [&]() {
+    uint64_t hash = 0;
+    {
+      FrameVector<vec3_packed> track;
+      rail.Positions(river.spline_stepsize(), &track);
+      FrameVector<bool> single_texture_zones(river.zones()->Length(), false);
+      RiverGeometry geometry;
+      BuildRiverGeometry(river, track.data(), track.size(), rail.wraps(),
+                         single_texture_zones, 1, &geometry);
+      hash = HashFloat(geometry.bank_indices.size(),
+                       geometry.bank_verts.back().pos.z);
+    }
+    arena.Reset();
+    return hash;
+  });
+  FrameArena::SetCurrent(nullptr);
+}
+
+// Loads an animation file for the AnimTable, as the game's LoadAnimFn does.
+static const char* LoadAnim(const char* anim_name, std::string* scratch_buf) {
+  return LoadAssetFile(anim_name, scratch_buf) ? scratch_buf->c_str()
+                                               : nullptr;
+}
+
+// The parts of Game that a World needs to load and update a level. Services
+// that only the menus and online features use are left null.
+class WorldFixture {
+ public:
+  WorldFixture()
+      : asset_manager_(renderer_),
+        graph_factory_(&module_registry_, &fplbase::LoadFile),
+        requested_state_(0) {}
+
+  // Follows Game::Initialize, without the fonts and Firebase. Only the mouse
+  // controller is added; LoadWorldDef needs one to hand to the player.
+  bool Initialize(const Config& config);
+
+  World* world() { return &world_; }
+
+ private:
+  void InitializeBreadboardModules(const Config& config);
+
+  fplbase::Renderer renderer_;
+  fplbase::InputSystem input_;
+  fplbase::AssetManager asset_manager_;
+  flatui::FontManager font_manager_;
+  pindrop::AudioEngine audio_engine_;
+  breadboard::ModuleRegistry module_registry_;
+  breadboard::module_library::DefaultGraphFactory graph_factory_;
+  GPGManager gpg_manager_;
+  WorldRenderer world_renderer_;
+  World world_;
+  std::string asset_manifest_source_;
+  std::string input_config_source_;
+  int requested_state_;
+};
+
+bool WorldFixture::Initialize(const Config& config) {
+  if (!renderer_.Initialize(mathfu::vec2i(kWindowWidth, kWindowHeight),
+                            config.window_title()->c_str())) {
+    fprintf(stderr, "Renderer initialization error: %s\n",
+            renderer_.last_error().c_str());
+    return false;
+  }
+  input_.Initialize();
+
+  if (!LoadAssetFile(config.assets_filename()->c_str(),
+                     &asset_manifest_source_)) {
+    return false;
+  }
+  const AssetManifest& asset_manifest =
+      *GetAssetManifest(asset_manifest_source_.c_str());
+  if (!world_.animation_component.anim_table().InitFromFlatBuffers(
+          *asset_manifest.anims(), LoadAnim)) {
+    return false;
+  }
+  if (!audio_engine_.Initialize(config.audio_config()->c_str())) {
+    return false;
+  }
+  audio_engine_.LoadSoundBank(asset_manifest.sound_bank()->c_str());
+  audio_engine_.StartLoadingSoundFiles();
+
+  if (!LoadAssetFile(config.input_config()->c_str(), &input_config_source_)) {
+    return false;
+  }
+
+  InitializeBreadboardModules(config);
+  world_.Initialize(config, &input_, &asset_manager_, &world_renderer_,
+                    &font_manager_, &audio_engine_, &graph_factory_,
+                    &renderer_, nullptr, nullptr, nullptr, nullptr, nullptr,
+                    nullptr, nullptr, nullptr, nullptr);
+
+  BasePlayerController* controller = new MouseController();
+  controller->set_input_config(GetInputConfig(input_config_source_.c_str()));
+  controller->set_input_system(&input_);
+  world_.AddController(controller);
+  return true;
+}
+
+// The same modules Game::InitializeBreadboardModules registers, so the
+// level's graphs are built exactly as they are in the game.
+void WorldFixture::InitializeBreadboardModules(const Config& config) {
+  graph_factory_.set_audio_engine(&audio_engine_);
+  breadboard::InitializeCommonModules(&module_registry_);
+
+  breadboard::module_library::InitializeAnimationModule(
+      &module_registry_, &world_.graph_component, &world_.animation_component,
+      &world_.transform_component);
+  breadboard::module_library::InitializeAudioModule(&module_registry_,
+                                                    &audio_engine_);
+  breadboard::module_library::InitializeEntityModule(
+      &module_registry_, &world_.entity_manager, &world_.meta_component,
+      &world_.graph_component);
+  breadboard::module_library::InitializePhysicsModule(
+      &module_registry_, &world_.physics_component, &world_.graph_component);
+  breadboard::module_library::InitializeRenderMeshModule(
+      &module_registry_, &world_.render_mesh_component);
+  breadboard::module_library::InitializeTransformModule(
+      &module_registry_, &world_.transform_component);
+  breadboard::module_library::InitializeVecModule(&module_registry_);
+
+  InitializeAttributesModule(&module_registry_, &world_.attributes_component,
+                             &world_.graph_component);
+  InitializeGpgModule(&module_registry_, &config, &gpg_manager_);
+  InitializePatronModule(&module_registry_, &world_.patron_component);
+  InitializePlayerModule(&module_registry_, &world_.player_component,
+                         &world_.graph_component);
+  InitializeRailDenizenModule(&module_registry_, &world_.rail_denizen_component,
+                              &world_.graph_component);
+  InitializeStateModule(&module_registry_, &requested_state_);
+  InitializeUiStringModule(&module_registry_, &world_.render_3d_text_component);
+  InitializeZooshiModule(&module_registry_, &world_.services_component,
+                         &world_.graph_component, &world_.scenery_component);
+}
+
+// LoadWorldDef, then one frame of the components and graphs that scale with
+// the size of the level. Each op that updates components is one frame; the
+// raft doesn't move, so after the warm-up run every frame does the same work.
+static void BenchmarkWorld(const WorldDef& world_def, size_t level_index,
+                           World* world) {
+  const std::string params =
+      "level=" +
+      std::string(world_def.levels()
+                      ->Get(static_cast<flatbuffers::uoffset_t>(level_index))
+                      ->name()
+                      ->c_str());
+  world->level_index = level_index;
+
+  // Also loads the level's meshes, shaders and graphs on the warm-up run;
+  // later runs find them in the asset manager and graph factory.
+  RunBenchmark("load_world_def", params, [&]() {
+    LoadWorldDef(world, &world_def);
+    uint64_t entities = 0;
+    for (auto iter = world->entity_manager.begin();
+         iter != world->entity_manager.end(); ++iter) {
+      ++entities;
+    }
+    return entities;
+  });
+
+  LoadWorldDef(world, &world_def);
+  FrameArena arena;
+  FrameArena::SetCurrent(&arena);
+
+  RunBenchmark("scenery_update", params, [&]() {
+    world->scenery_component.UpdateAllEntities(kFrameTime);
+    arena.Reset();
+    uint64_t hash = 0;
+    for (auto iter = world->scenery_component.begin();
+         iter != world->scenery_component.end(); ++iter) {
+      hash = hash * 31 + static_cast<uint64_t>(iter->data.state);
+    }
+    return hash;
+  });
+
+  RunBenchmark("lap_dependent_update", params, [&]() {
+    world->lap_dependent_component.UpdateAllEntities(kFrameTime);
+    arena.Reset();
+    uint64_t hash = 0;
+    for (auto iter = world->lap_dependent_component.begin();
+         iter != world->lap_dependent_component.end(); ++iter) {
+      hash = hash * 2 + (iter->data.currently_active ? 1 : 0);
+    }
+    return hash;
+  });
+
+  // Interpreted breadboard dispatch: the advance_frame event every graph
+  // that draws the score listens to, then a new_lap event on every rail
+  // denizen that has a graph, as RailDenizenComponent sends at each lap.
+  RunBenchmark("graph_dispatch", params, [&]() {
+    world->graph_component.advance_frame_broadcaster()->BroadcastEvent(
+        corgi::component_library::kAdvanceFrameEventId);
+    uint64_t graphs = 0;
+    for (auto iter = world->rail_denizen_component.begin();
+         iter != world->rail_denizen_component.end(); ++iter) {
+      corgi::component_library::GraphData* graph_data =
+          world->graph_component.GetComponentData(iter->entity);
+      if (graph_data) {
+        graph_data->broadcaster.BroadcastEvent(kNewLapEventId);
+        ++graphs;
+      }
+    }
+    arena.Reset();
+    return graphs;
+  });
+
+  FrameArena::SetCurrent(nullptr);
+}
+
+static int RunBenchmarks(int argc, char* argv[]) {
+  const std::string assets = argc > 1 ? argv[1] : "assets";
+  if (argc > 2) g_filter = argv[2];
+  if (argc > 3) g_overlay = argv[3];
+
+  static const int kPatronCounts[] = {8, 32, 128};
+  static const int kProjectileCounts[] = {1, 8, 32};
+  for (size_t i = 0; i < sizeof(kPatronCounts) / sizeof(kPatronCounts[0]);
+       ++i) {
+    for (size_t j = 0;
+         j < sizeof(kProjectileCounts) / sizeof(kProjectileCounts[0]); ++j) {
+      BenchmarkClosestProjectile(kPatronCounts[i], kProjectileCounts[j]);
+    }
+  }
+
+  // The World loads everything relative to the assets directory, as it does
+  // in the game.
+#ifdef _WIN32
+  const bool changed_dir = _chdir(assets.c_str()) == 0;
+#else
+  const bool changed_dir = chdir(assets.c_str()) == 0;
+#endif  // _WIN32
+  std::string config_source;
+  std::vector<std::unique_ptr<LevelFixture>> levels;
+  fplbase::SetLoadFileFunction(LoadOverlayFile);
+  if (!changed_dir || !LoadLevels(&config_source, &levels)) {
+    fprintf(stderr, "Level benchmarks skipped; pass the built assets "
+                    "directory as the first argument.\n");
+    return 0;
+  }
+  for (size_t i = 0; i < levels.size(); ++i) {
+    BenchmarkRails(*levels[i]);
+    BenchmarkRiverGeometry(*levels[i]);
+  }
+
+  const Config& config = *GetConfig(config_source.c_str());
+  std::unique_ptr<WorldFixture> fixture(new WorldFixture());
+  if (!fixture->Initialize(config)) {
+    fprintf(stderr, "World benchmarks skipped; they need a display.\n");
+    return 0;
+  }
+  for (size_t i = 0; i < levels.size(); ++i) {
+    BenchmarkWorld(*config.world_def(), i, fixture->world());
+  }
+  return 0;
+}
+
+}  // zooshi
+}  // fpl
+
+int main(int argc, char* argv[]) {
+  return fpl::zooshi::RunBenchmarks(argc, argv);
+}
@@ -24,9 +24,16 @@
 CORGI_DEFINE_COMPONENT(fpl::zooshi::AttributesComponent,
                        fpl::zooshi::AttributesData)
 
+using corgi::component_library::GraphData;
+
 namespace fpl {
 namespace zooshi {
 
+BREADBOARD_DEFINE_EVENT(kAttributesChangedEventId)
+
+static_assert(AttributeDef_Size <= 32,
+              "Attribute dirty bits must fit in a uint32_t.");
+
 void AttributesComponent::Init() {
   ServicesComponent* services =
       entity_manager_->GetComponent<ServicesComponent>();
@@ -40,6 +47,90 @@ void AttributesComponent::AddFromRawData(corgi::EntityRef& entity,
   AddEntity(entity);
 }
 
+void AttributesComponent::InitEntity(corgi::EntityRef& entity) {
+  AttributesData* attributes_data = GetComponentData(entity);
+  size_t row;
+  if (free_rows_.empty()) {
+    row = row_entities_.size();
+    row_entities_.push_back(entity);
+    dirty_bits_.push_back(0);
+    for (int i = 0; i < AttributeDef_Size; ++i) {
+      columns_[i].push_back(0.0f);
+    }
+  } else {
+    row = free_rows_.back();
+    free_rows_.pop_back();
+    row_entities_[row] = entity;
+    for (int i = 0; i < AttributeDef_Size; ++i) {
+      columns_[i][row] = 0.0f;
+    }
+  }
+  attributes_data->row = row;
+
+  // Start the game with a requirement of 1 point.
+  // TODO: Move this into a data file.
+  columns_[AttributeDef_TargetScore][row] = 1;
+
+  // Start the game with a last lap score of 0 point.
+  // TODO: Move this into a data file.
+  columns_[AttributeDef_LastLapScore][row] = 0;
+
+  // Start the game with a last lap num of -1, which means before first lap.
+  // TODO: Move this into a data file.
+  columns_[AttributeDef_LastLapNumber][row] = -1;
+
+  // Start the game with quota requirement going up by 24
+  // after the first lap.
+  // TODO: Move this into a data file.
+  columns_[AttributeDef_TargetScoreIncrease][row] = 24;
+
+  // Everything counts as changed so listeners pick up the initial values.
+  if (dirty_bits_[row] == 0) dirty_rows_.push_back(row);
+  dirty_bits_[row] = (1u << AttributeDef_Size) - 1;
+}
+
+void AttributesComponent::CleanupEntity(corgi::EntityRef& entity) {
+  AttributesData* attributes_data = GetComponentData(entity);
+  size_t row = attributes_data->row;
+  if (row == AttributesData::kInvalidRow) return;
+  // The row stays in dirty_rows_ if it is there; UpdateAllEntities skips rows
+  // whose entity is no longer valid.
+  dirty_bits_[row] = 0;
+  row_entities_[row] = corgi::EntityRef();
+  free_rows_.push_back(row);
+  attributes_data->row = AttributesData::kInvalidRow;
+}
+
+void AttributesComponent::SetAttribute(const corgi::EntityRef& entity,
+                                       AttributeDef attribute, float value) {
+  size_t row = RowOf(entity);
+  float& current = columns_[attribute][row];
+  if (current == value) return;
+  current = value;
+  if (dirty_bits_[row] == 0) dirty_rows_.push_back(row);
+  dirty_bits_[row] |= 1u << attribute;
+}
+
+void AttributesComponent::UpdateAllEntities(corgi::WorldTime /*delta_time*/) {
+  if (dirty_rows_.empty()) return;
+  // Graphs may change attributes again; those changes are picked up next
+  // frame.
+  std::vector<size_t>& rows = flushing_rows_;
+  rows.swap(dirty_rows_);
+  for (size_t i = 0; i < rows.size(); ++i) {
+    size_t row = rows[i];
+    uint32_t bits = dirty_bits_[row];
+    dirty_bits_[row] = 0;
+    corgi::EntityRef entity = row_entities_[row];
+    if (bits == 0 || !entity.IsValid()) continue;
+    GraphData* graph_data = Data<GraphData>(entity);
+    if (graph_data) {
+      graph_data->broadcaster.BroadcastEvent(kAttributesChangedEventId);
+    }
+  }
+  rows.clear();
+}
+
 corgi::ComponentInterface::RawDataUniquePtr AttributesComponent::ExportRawData(
     const corgi::EntityRef& entity) const {
   if (GetComponentData(entity) == nullptr) return nullptr;
@@ -15,7 +15,10 @@
 #ifndef FPL_COMPONENTS_ATTRIBUTES_H_
 #define FPL_COMPONENTS_ATTRIBUTES_H_
 
+#include <vector>
+
 #include "attributes_generated.h"
+#include "breadboard/event.h"
 #include "config_generated.h"
 #include "corgi/component.h"
 #include "flatui/font_manager.h"
@@ -29,32 +32,20 @@ class FontManager;
 namespace fpl {
 namespace zooshi {
 
-// Data for scene object components.
+// Broadcast on an entity's graph broadcaster once per frame if any of its
+// attributes changed value.
+BREADBOARD_DECLARE_EVENT(kAttributesChangedEventId)
+
+// Data for scene object components. The attribute values themselves are kept
+// by AttributesComponent in one contiguous column per AttributeDef; this only
+// records which row of those columns belongs to the entity.
 class AttributesData {
  public:
-  AttributesData() {
-    for (int i = 0; i < AttributeDef_Size; ++i) {
-      attributes[i] = 0;
-    }
-    // Start the game with a requirement of 1 point.
-    // TODO: Move this into a data file.
-    attributes[AttributeDef_TargetScore] = 1;
-
-    // Start the game with a last lap score of 0 point.
-    // TODO: Move this into a data file.
-    attributes[AttributeDef_LastLapScore] = 0;
-
-    // Start the game with a last lap num of -1, which means before first lap.
-    // TODO: Move this into a data file.
-    attributes[AttributeDef_LastLapNumber] = -1;
-
-    // Start the game with quota requirement going up by 24
-    // after the first lap.
-    // TODO: Move this into a data file.
-    attributes[AttributeDef_TargetScoreIncrease] = 24;
-  }
+  static const size_t kInvalidRow = static_cast<size_t>(-1);
+
+  AttributesData() : row(kInvalidRow) {}
 
-  float attributes[AttributeDef_Size];
+  size_t row;
 };
 
 class AttributesComponent : public corgi::Component<AttributesData> {
@@ -64,12 +55,63 @@ class AttributesComponent : public corgi::Component<AttributesData> {
   virtual void Init();
   virtual void AddFromRawData(corgi::EntityRef& entity, const void* raw_data);
   virtual RawDataUniquePtr ExportRawData(const corgi::EntityRef& entity) const;
-  virtual void InitEntity(corgi::EntityRef& /*entity*/) {}
+  virtual void InitEntity(corgi::EntityRef& entity);
+  virtual void CleanupEntity(corgi::EntityRef& entity);
+  // Notifies the graphs of entities whose attributes changed this frame.
+  virtual void UpdateAllEntities(corgi::WorldTime delta_time);
+
+  // Returns the value of `attribute` for `entity`, which must have attributes.
+  float GetAttribute(const corgi::EntityRef& entity,
+                     AttributeDef attribute) const {
+    return columns_[attribute][RowOf(entity)];
+  }
+
+  // Sets the value of `attribute`. Only marks it as changed if the value is
+  // actually different.
+  void SetAttribute(const corgi::EntityRef& entity, AttributeDef attribute,
+                    float value);
+
+  // Adds `delta` to the value of `attribute`.
+  void IncrementAttribute(const corgi::EntityRef& entity,
+                          AttributeDef attribute, float delta) {
+    SetAttribute(entity, attribute, GetAttribute(entity, attribute) + delta);
+  }
+
+  // Returns true if `attribute` changed since the last UpdateAllEntities.
+  bool IsAttributeDirty(const corgi::EntityRef& entity,
+                        AttributeDef attribute) const {
+    return (dirty_bits_[RowOf(entity)] & (1u << attribute)) != 0;
+  }
+
+  // The values of `attribute` for every entity, indexed by
+  // AttributesData::row. Rows of removed entities are left in place and
+  // reused.
+  const std::vector<float>& column(AttributeDef attribute) const {
+    return columns_[attribute];
+  }
 
  private:
+  size_t RowOf(const corgi::EntityRef& entity) const {
+    const AttributesData* data = GetComponentData(entity);
+    assert(data && data->row != AttributesData::kInvalidRow);
+    return data->row;
+  }
+
   fplbase::InputSystem* input_system_;
   fplbase::AssetManager* asset_manager_;
   flatui::FontManager* font_manager_;
+
+  // One contiguous array per attribute.
+  std::vector<float> columns_[AttributeDef_Size];
+  // Bit `i` of a row's mask is set if AttributeDef `i` has changed.
+  std::vector<uint32_t> dirty_bits_;
+  // The entity that owns each row.
+  std::vector<corgi::EntityRef> row_entities_;
+  // Rows with at least one dirty bit, so the update need not scan them all.
+  std::vector<size_t> dirty_rows_;
+  // Scratch space for UpdateAllEntities, kept to avoid reallocating.
+  std::vector<size_t> flushing_rows_;
+  std::vector<size_t> free_rows_;
 };
 
 }  // zooshi
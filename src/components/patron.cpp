@@ -108,7 +108,7 @@ void PatronComponent::Init() {
   SceneLab* scene_lab = services->scene_lab();
   if (scene_lab) {
     scene_lab->AddOnEnterEditorCallback([this]() { UpdateAndEnablePhysics(); });
-    scene_lab->AddOnExitEditorCallback([this]() { PostLoadFixup(); });
+    scene_lab->AddOnExitEditorCallback([this]() { ResetEntityStates(); });
   }
 }
 
@@ -254,50 +254,72 @@ void PatronComponent::UpdateAndEnablePhysics() {
 }
 
 void PatronComponent::PostLoadFixup() {
+  // Initialize each patron.
+  for (auto iter = component_data_.begin(); iter != component_data_.end();
+       ++iter) {
+    EntityPostLoadFixup(iter->entity);
+  }
+}
+
+void PatronComponent::EntityPostLoadFixup(corgi::EntityRef& patron) {
+  CacheEntityLinks(patron);
+  ResetEntityState(patron);
+}
+
+void PatronComponent::ResetEntityStates() {
+  for (auto iter = component_data_.begin(); iter != component_data_.end();
+       ++iter) {
+    ResetEntityState(iter->entity);
+  }
+}
+
+void PatronComponent::CacheEntityLinks(corgi::EntityRef& patron) {
+  PatronData* patron_data = GetComponentData(patron);
+  if (patron_data == nullptr) return;
+
   const TransformComponent* transform_component =
       entity_manager_->GetComponent<TransformComponent>();
 
-  // Initialize each patron.
+  // Get reference to the first child with a rendermesh. We assume there will
+  // only be one such child.
+  patron_data->render_child = transform_component->ChildWithComponent(
+      patron, RenderMeshComponent::GetComponentId());
+  assert(patron_data->render_child);
+
+  // Animate the entity with the rendermesh.
+  entity_manager_->AddEntityToComponent<AnimationComponent>(
+      patron_data->render_child);
+  AnimationData* animation_data =
+      Data<AnimationData>(patron_data->render_child);
+  animation_data->anim_table_object = patron_data->anim_object;
+
+  // Cache the index into the physics target body.
+  const PhysicsData* physics_data = Data<PhysicsData>(patron);
+  const int target_index =
+      physics_data->RigidBodyIndex(patron_data->target_tag);
+  patron_data->target_rigid_body_index = target_index < 0 ? 0 : target_index;
+}
+
+void PatronComponent::ResetEntityState(corgi::EntityRef& patron) {
+  PatronData* patron_data = GetComponentData(patron);
+  if (patron_data == nullptr) return;
+
+  // Initialize state machine.
+  SetState(kPatronStateLayingDown, patron_data);
+
+  // Reset the last lap the patron stood up.
+  patron_data->last_lap_upright = -1.0f;
+  patron_data->last_lap_fed = -1.0f;
+
   auto physics_component = entity_manager_->GetComponent<PhysicsComponent>();
-  for (auto iter = component_data_.begin(); iter != component_data_.end();
-       ++iter) {
-    corgi::EntityRef patron = iter->entity;
-    PatronData* patron_data = Data<PatronData>(patron);
 
-    // Get reference to the first child with a rendermesh. We assume there will
-    // only be one such child.
-    patron_data->render_child = transform_component->ChildWithComponent(
-        patron, RenderMeshComponent::GetComponentId());
-    assert(patron_data->render_child);
-
-    // Animate the entity with the rendermesh.
-    entity_manager_->AddEntityToComponent<AnimationComponent>(
-        patron_data->render_child);
-    AnimationData* animation_data =
-        Data<AnimationData>(patron_data->render_child);
-    animation_data->anim_table_object = patron_data->anim_object;
-
-    // Initialize state machine.
-    SetState(kPatronStateLayingDown, patron_data);
-
-    // Reset the last lap the patron stood up.
-    patron_data->last_lap_upright = -1.0f;
-    patron_data->last_lap_fed = -1.0f;
-
-    // Cache the index into the physics target body.
-    const PhysicsData* physics_data = Data<PhysicsData>(patron);
-    const int target_index =
-        physics_data->RigidBodyIndex(patron_data->target_tag);
-    patron_data->target_rigid_body_index = target_index < 0 ? 0 : target_index;
-
-    // Patrons that are done should not have physics enabled.
-    physics_component->DisablePhysics(patron);
-    // We don't want patrons moving until they are up.
-    RailDenizenData* rail_denizen_data = Data<RailDenizenData>(patron);
-    if (rail_denizen_data != nullptr) {
-      rail_denizen_data->enabled = false;
-      rail_denizen_data->SetSplinePlaybackRate(0.0f);
-    }
+  // Patrons that are done should not have physics enabled.
+  physics_component->DisablePhysics(patron);
+  // We don't want patrons moving until they are up.
+  RailDenizenData* rail_denizen_data = Data<RailDenizenData>(patron);
+  if (rail_denizen_data != nullptr) {
+    rail_denizen_data->enabled = false;
+    rail_denizen_data->SetSplinePlaybackRate(0.0f);
   }
 }
 
@@ -467,6 +489,7 @@ void PatronComponent::UpdateAllEntities(corgi::WorldTime delta_time) {
       entity_manager_->GetComponent<ServicesComponent>()->raft_entity();
   if (!raft) return;
   const RailDenizenData* raft_rail_denizen = Data<RailDenizenData>(raft);
+  GatherCatchCandidates();
   for (auto iter = component_data_.begin(); iter != component_data_.end();
        ++iter) {
     corgi::EntityRef patron = iter->entity;
@@ -630,6 +653,9 @@ void PatronComponent::Animate(PatronData* patron_data, PatronAction action) {
 void PatronComponent::CollisionHandler(CollisionData* collision_data,
                                        void* user_data) {
   PatronComponent* patron_component = static_cast<PatronComponent*>(user_data);
+  patron_component->entity_manager_->GetComponent<ServicesComponent>()
+      ->world()
+      ->stats.Add(kStatPhysicsContacts, 1);
   if (patron_component->IsRegisteredWithComponent<PatronComponent>(
           collision_data->this_entity)) {
     patron_component->HandleCollision(collision_data->this_entity,
@@ -678,15 +704,21 @@ void PatronComponent::HandleCollision(const corgi::EntityRef& patron_entity,
       entity_manager_->DeleteEntity(proj_entity);
 
       // Track in Analytics that the patron was fed.
-      MetaData* meta_data = Data<MetaData>(patron_entity);
-      firebase::analytics::Parameter parameters[] = {
-          firebase::analytics::Parameter(kParameterPatronType,
-                                         meta_data->prototype.c_str()),
-          AnalyticsControlParameter(
-              entity_manager_->GetComponent<ServicesComponent>()->world()),
-      };
-      firebase::analytics::LogEvent(kEventPatronFed, parameters,
-                                    sizeof(parameters) / sizeof(parameters[0]));
+      World* world =
+          entity_manager_->GetComponent<ServicesComponent>()->world();
+      PatronData* patron_data = Data<PatronData>(patron_entity);
+      if (!patron_data->analytics_type_interned) {
+        MetaData* meta_data = Data<MetaData>(patron_entity);
+        patron_data->analytics_type =
+            world->analytics.Intern(meta_data->prototype.c_str());
+        patron_data->analytics_type_interned = true;
+      }
+      world->analytics.LogEvent(
+          AnalyticsEvent(kAnalyticsEventPatronFed)
+              .AddName(kAnalyticsParameterPatronType,
+                       patron_data->analytics_type)
+              .AddName(kAnalyticsParameterControlScheme,
+                       AnalyticsControlValue(world)));
     }
   }
 }
@@ -782,45 +814,23 @@ vec3 PatronComponent::RaftPosition() const {
   return raft_transform->position;
 }
 
-const EntityRef* PatronComponent::ClosestProjectile(
-    const EntityRef& patron, vec3* closest_position,
-    motive::Angle* closest_face_angle, float* closest_time) const {
-  // TODO: change projectile_component to const when Component gets a
-  //       const_iterator.
-  PlayerProjectileComponent* projectile_component =
-      entity_manager_->GetComponent<PlayerProjectileComponent>();
-  const TransformData* patron_transform = Data<TransformData>(patron);
-  const PatronData* patron_data = GetComponentData(patron);
-
-  // Gather patron details. These are independent of the projectiles.
-  const vec3 patron_position_xy = ZeroHeight(patron_transform->position);
-  const motive::Range target_height_range = TargetHeightRange(patron);
-  const vec3 return_position_xy = ZeroHeight(patron_data->return_position);
-
-  // Gather data about the raft, which is needed in the calculations.
-  const vec3 raft_position_xy = ZeroHeight(RaftPosition());
-
-  // Loop through every projectile. Keep a reference to the closest one.
-  const EntityRef* closest_ref = nullptr;
-  float max_dist_sq = patron_data->max_catch_distance_for_search *
-                      patron_data->max_catch_distance_for_search;
+int FindClosestCatch(const CatchQuery& query, const CatchCandidate* candidates,
+                     size_t num_candidates, CatchIntercept* intercept) {
+  // Loop through every projectile. Keep the index of the closest one.
+  int closest_index = -1;
+  const float max_dist_sq = query.max_catch_distance_for_search *
+                            query.max_catch_distance_for_search;
   float closest_dist_sq = max_dist_sq;
-  vec3 closest_position_xy = mathfu::kZeros3f;
-  auto physics_component = entity_manager_->GetComponent<PhysicsComponent>();
-  for (auto it = projectile_component->begin();
-       it != projectile_component->end(); ++it) {
+  for (size_t i = 0; i < num_candidates; ++i) {
     // Get movement state of projectile.
-    const TransformData* projectile_transform =
-        entity_manager_->GetComponentData<TransformData>(it->entity);
-    const PhysicsData* projectile_physics =
-        entity_manager_->GetComponentData<PhysicsData>(it->entity);
-    const vec3 projectile_position = projectile_transform->position;
-    const vec3 projectile_velocity = projectile_physics->Velocity();  // In m/s.
+    const CatchCandidate& candidate = candidates[i];
+    const vec3 projectile_position(candidate.position);
+    const vec3 projectile_velocity(candidate.velocity);  // In m/s.
     const vec3 projectile_position_xy = ZeroHeight(projectile_position);
     const vec3 projectile_velocity_xy = ZeroHeight(projectile_velocity);
 
     // Get horizontal unit vector and distance to patron.
-    vec3 to_patron_xy = patron_position_xy - projectile_position_xy;
+    vec3 to_patron_xy = query.patron_position_xy - projectile_position_xy;
     const float dist_to_patron_xy = to_patron_xy.Normalize();
 
     // Get time to closest point on horizontal trajectory.
@@ -836,67 +846,114 @@ const EntityRef* PatronComponent::ClosestProjectile(
         projectile_position_xy +
         projectile_velocity_xy * closest_t_ignore_height;
     const float dist_sq_ignore_height =
-        (patron_position_xy - closest_position_ignore_height_xy)
+        (query.patron_position_xy - closest_position_ignore_height_xy)
             .LengthSquared();
     if (dist_sq_ignore_height > closest_dist_sq) continue;
 
     // If returning from a previous attempt, limit how far from the initial
     // position to leave from again.
-    if (patron_data->move_state == kPatronMoveStateReturn) {
+    if (query.returning) {
       const float dist_sq =
-          (return_position_xy - closest_position_ignore_height_xy)
+          (query.return_position_xy - closest_position_ignore_height_xy)
               .LengthSquared();
       if (dist_sq > max_dist_sq) continue;
     }
 
     // Get the closest time at a catchable height.
     const float closest_t = CalculateClosestTimeInHeightRange(
-        closest_t_ignore_height, patron_data->catch_time_for_search,
-        target_height_range, projectile_position.z, projectile_velocity.z,
-        physics_component->GravityForEntity(it->entity));
-    if (!patron_data->catch_time_for_search.Contains(closest_t)) continue;
+        closest_t_ignore_height, query.catch_time_for_search,
+        query.target_height_range, projectile_position.z,
+        projectile_velocity.z, candidate.gravity);
+    if (!query.catch_time_for_search.Contains(closest_t)) continue;
 
     // Calculate the projectile position at `closest_t`.
     const vec3 intercept_position_xy =
         projectile_position_xy + projectile_velocity_xy * closest_t;
     const float dist_sq =
-        (patron_position_xy - intercept_position_xy).LengthSquared();
+        (query.patron_position_xy - intercept_position_xy).LengthSquared();
     if (dist_sq > closest_dist_sq) continue;
 
     // Don't face too far away from the player in order to catch thrown sushi.
     motive::Angle angle_to_sushi = motive::Angle::FromYXVector(
         projectile_position_xy - intercept_position_xy);
-    motive::Angle angle_to_raft =
-        motive::Angle::FromYXVector(raft_position_xy - intercept_position_xy);
+    motive::Angle angle_to_raft = motive::Angle::FromYXVector(
+        query.raft_position_xy - intercept_position_xy);
     motive::Angle difference = angle_to_raft - angle_to_sushi;
-    if (fabs(difference.ToDegrees()) > patron_data->max_catch_angle) continue;
+    if (fabs(difference.ToDegrees()) > query.max_catch_angle) continue;
 
     // TODO: prefer projectiles that are slightly farther but with much more
     //       time to close the distance.
-    closest_position_xy = intercept_position_xy;
-    *closest_time = closest_t;
-    *closest_face_angle = motive::Angle::FromYXVector(projectile_position_xy -
-                                                      intercept_position_xy);
-    closest_ref = &it->entity;
+    intercept->position_xy = intercept_position_xy;
+    intercept->time = closest_t;
+    intercept->face_angle = angle_to_sushi;
+    intercept->dist_sq = dist_sq;
+    closest_index = static_cast<int>(i);
     closest_dist_sq = dist_sq;
   }
+  return closest_index;
+}
 
-  // Clamp the movement time so the patron doesn't move to quickly or slowly.
-  if (closest_ref != nullptr) {
-    const float clamped_dist =
-        std::min(std::sqrt(closest_dist_sq), patron_data->max_catch_distance);
-    const float avg_speed = clamped_dist / *closest_time;
-    const float clamped_speed = patron_data->catch_speed.Clamp(avg_speed);
-    *closest_time = patron_data->catch_time.Clamp(clamped_dist / clamped_speed);
-
-    // Ensure the returned `closest_position` is not farther than
-    // max_catch_distance from the last idle position.
-    const vec3 direction =
-        (closest_position_xy - return_position_xy).Normalized();
-    *closest_position = return_position_xy + clamped_dist * direction;
-    closest_position->z = patron_transform->position.z;
+void PatronComponent::GatherCatchCandidates() {
+  // TODO: change projectile_component to const when Component gets a
+  //       const_iterator.
+  PlayerProjectileComponent* projectile_component =
+      entity_manager_->GetComponent<PlayerProjectileComponent>();
+  auto physics_component = entity_manager_->GetComponent<PhysicsComponent>();
+  catch_candidates_.clear();
+  for (auto it = projectile_component->begin();
+       it != projectile_component->end(); ++it) {
+    const TransformData* projectile_transform =
+        entity_manager_->GetComponentData<TransformData>(it->entity);
+    const PhysicsData* projectile_physics =
+        entity_manager_->GetComponentData<PhysicsData>(it->entity);
+    CatchCandidate candidate;
+    candidate.entity = it->entity;
+    candidate.position = projectile_transform->position;
+    candidate.velocity = projectile_physics->Velocity();
+    candidate.gravity = physics_component->GravityForEntity(it->entity);
+    catch_candidates_.push_back(candidate);
   }
-  return closest_ref;
+}
+
+const EntityRef* PatronComponent::ClosestProjectile(
+    const EntityRef& patron, vec3* closest_position,
+    motive::Angle* closest_face_angle, float* closest_time) const {
+  const TransformData* patron_transform = Data<TransformData>(patron);
+  const PatronData* patron_data = GetComponentData(patron);
+
+  // Gather patron details. These are independent of the projectiles.
+  CatchQuery query;
+  query.patron_position_xy = ZeroHeight(patron_transform->position);
+  query.return_position_xy = ZeroHeight(patron_data->return_position);
+  query.raft_position_xy = ZeroHeight(RaftPosition());
+  query.target_height_range = TargetHeightRange(patron);
+  query.catch_time_for_search = patron_data->catch_time_for_search;
+  query.max_catch_distance_for_search =
+      patron_data->max_catch_distance_for_search;
+  query.max_catch_angle = patron_data->max_catch_angle;
+  query.returning = patron_data->move_state == kPatronMoveStateReturn;
+
+  CatchIntercept intercept;
+  const int closest_index =
+      FindClosestCatch(query, catch_candidates_.data(),
+                       catch_candidates_.size(), &intercept);
+  if (closest_index < 0) return nullptr;
+
+  // Clamp the movement time so the patron doesn't move to quickly or slowly.
+  const float clamped_dist = std::min(std::sqrt(intercept.dist_sq),
+                                      patron_data->max_catch_distance);
+  const float avg_speed = clamped_dist / intercept.time;
+  const float clamped_speed = patron_data->catch_speed.Clamp(avg_speed);
+  *closest_time = patron_data->catch_time.Clamp(clamped_dist / clamped_speed);
+  *closest_face_angle = intercept.face_angle;
+
+  // Ensure the returned `closest_position` is not farther than
+  // max_catch_distance from the last idle position.
+  const vec3 direction =
+      (intercept.position_xy - query.return_position_xy).Normalized();
+  *closest_position = query.return_position_xy + clamped_dist * direction;
+  closest_position->z = patron_transform->position.z;
+  return &catch_candidates_[closest_index].entity;
 }
 
 void PatronComponent::FindProjectileAndCatch(const EntityRef& patron) {
@@ -15,6 +15,9 @@
 #ifndef FPL_ZOOSHI_COMPONENTS_PATRON_H_
 #define FPL_ZOOSHI_COMPONENTS_PATRON_H_
 
+#include <vector>
+
+#include "analytics_logger.h"
 #include "breadboard/event.h"
 #include "breadboard/graph.h"
 #include "breadboard/graph_state.h"
@@ -126,7 +129,9 @@ struct PatronData {
         rail_accelerate_time(0.0f),
         time_to_face_raft(0.0f),
         time_exasperated_before_disappearing(1.0f),
-        exasperated_playback_rate(2.0f) {}
+        exasperated_playback_rate(2.0f),
+        analytics_type(kInvalidAnalyticsId),
+        analytics_type_interned(false) {}
 
   // Whether the patron is standing up or falling down.
   PatronState state;
@@ -267,8 +272,50 @@ struct PatronData {
   // If true: when fed play eat, satisfied, disappear animations.
   // If false: when fed play satisfied, disappear animations.
   bool play_eating_animation;
+
+  // The patron's prototype, interned for analytics the first time it is fed.
+  AnalyticsId analytics_type;
+  // True once interning has been tried, so a full name table isn't searched
+  // again on every feed. analytics_type stays invalid if it failed.
+  bool analytics_type_interned;
+};
+
+// A projectile's motion, as seen by a patron deciding what to catch.
+struct CatchCandidate {
+  corgi::EntityRef entity;
+  mathfu::vec3_packed position;
+  mathfu::vec3_packed velocity;
+  float gravity;
 };
 
+// Everything about a patron that its search for a projectile depends on.
+// Positions have their height zeroed.
+struct CatchQuery {
+  mathfu::vec3 patron_position_xy;
+  mathfu::vec3 return_position_xy;
+  mathfu::vec3 raft_position_xy;
+  motive::Range target_height_range;
+  motive::Range catch_time_for_search;
+  float max_catch_distance_for_search;
+  float max_catch_angle;
+  // True if the patron is returning from a previous attempt.
+  bool returning;
+};
+
+// Where and when a patron can intercept a projectile.
+struct CatchIntercept {
+  mathfu::vec3 position_xy;
+  motive::Angle face_angle;
+  float time;
+  float dist_sq;
+};
+
+// Returns the index into `candidates` of the closest projectile the patron
+// described by `query` can catch, and fills in `intercept`. Returns -1 if
+// none can be caught.
+int FindClosestCatch(const CatchQuery& query, const CatchCandidate* candidates,
+                     size_t num_candidates, CatchIntercept* intercept);
+
 class PatronComponent : public corgi::Component<PatronData> {
  public:
   PatronComponent() : config_(nullptr), event_time_(-1) {}
@@ -284,6 +331,12 @@ class PatronComponent : public corgi::Component<PatronData> {
 
   // This needs to be called after the entities have been loaded from data.
   void PostLoadFixup();
+  // The same, for a single entity loaded after the rest of the level. Does
+  // nothing if `entity` is not a patron.
+  void EntityPostLoadFixup(corgi::EntityRef& entity);
+  // The part of EntityPostLoadFixup() that depends on how the patron is put
+  // together, redone when the patron is edited in Scene Lab.
+  void CacheEntityLinks(corgi::EntityRef& patron);
 
   // Each patron (optionally) holds a sequence of animations in
   // `PatronData::events`. These events are followed after StartEvent() is
@@ -301,6 +354,9 @@ class PatronComponent : public corgi::Component<PatronData> {
       corgi::component_library::CollisionData* collision_data, void* user_data);
 
  private:
+  // Put a patron back to the way it is at the start of a level.
+  void ResetEntityState(corgi::EntityRef& patron);
+  void ResetEntityStates();
   void HandleCollision(const corgi::EntityRef& patron_entity,
                        const corgi::EntityRef& proj_entity,
                        const std::string& part_tag);
@@ -328,6 +384,7 @@ class PatronComponent : public corgi::Component<PatronData> {
                                             motive::Angle* closest_face_angle,
                                             float* closest_time) const;
   void FindProjectileAndCatch(const corgi::EntityRef& patron);
+  void GatherCatchCandidates();
   void MoveToTarget(const corgi::EntityRef& patron,
                     const mathfu::vec3& target_position,
                     motive::Angle target_face_angle, float target_time);
@@ -339,6 +396,10 @@ class PatronComponent : public corgi::Component<PatronData> {
 
   // Current time into the "event". i.e. the set-up sequence of animations.
   corgi::WorldTime event_time_;
+
+  // Every projectile in flight, gathered once per update so that each
+  // patron's search doesn't have to look up the projectile components again.
+  std::vector<CatchCandidate> catch_candidates_;
 };
 
 }  // zooshi
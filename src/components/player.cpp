@@ -46,29 +46,70 @@ using corgi::component_library::TransformData;
 void PlayerComponent::Init() {
   config_ = entity_manager_->GetComponent<ServicesComponent>()->config();
 }
+
+// Presses that have waited longer than this, in milliseconds, were made while
+// the player could not throw (e.g. during a menu) and are dropped.
+static const int32_t kMaxPressAge = 250;
+// The most a projectile is moved forward to make up for the time between its
+// press and the update that handles it, in seconds.
+static const float kMaxFireTimeOffset = 0.1f;
+
 void PlayerComponent::UpdateAllEntities(corgi::WorldTime /*delta_time*/) {
+  // Take every press recorded since the last update off the queue, so that
+  // presses shorter than an update are not missed.
+  presses_.clear();
+  ServicesComponent* services =
+      entity_manager_->GetComponent<ServicesComponent>();
+  InputEventQueue& input_events = services->world()->input_events;
+  const uint32_t now = InputEventTicks(*services->input_system());
+  InputEvent press;
+  while (input_events.Pop(&press)) {
+    if (static_cast<int32_t>(now - press.timestamp) <= kMaxPressAge) {
+      presses_.push_back(press);
+    }
+  }
+
   for (auto iter = component_data_.begin(); iter != component_data_.end();
        ++iter) {
     PlayerData* player_data = Data<PlayerData>(iter->entity);
     TransformData* transform_data = Data<TransformData>(iter->entity);
+    BasePlayerController* controller = player_data->input_controller();
     if (state_ != kPlayerState_Disabled) {
-      player_data->input_controller()->Update();
+      controller->Update();
     }
     transform_data->orientation =
         mathfu::quat::RotateFromTo(player_data->GetFacing(), mathfu::kAxisY3f);
-    if (state_ == kPlayerState_Active &&
-        player_data->input_controller()->Button(kFireProjectile).Value() &&
-        player_data->input_controller()->Button(kFireProjectile).HasChanged()) {
-      SpawnProjectile(iter->entity);
-
-      GraphData* graph_data = Data<GraphData>(iter->entity);
-      if (graph_data) {
-        graph_data->broadcaster.BroadcastEvent(kOnFireEventId);
+    if (state_ != kPlayerState_Active) continue;
+
+    if (controller->FiresOnPointerPress()) {
+      // One throw per press, each aimed where that press was made.
+      for (auto press = presses_.begin(); press != presses_.end(); ++press) {
+        const mathfu::vec2i aim =
+            controller->AimsWithPointer() ? press->position : mathfu::vec2i(-1);
+        // Presses can land after `now` was read, so the age may be negative.
+        const int32_t age = static_cast<int32_t>(now - press->timestamp);
+        const float time_offset = mathfu::Clamp(
+            static_cast<float>(age) / corgi::kMillisecondsPerSecond, 0.0f,
+            kMaxFireTimeOffset);
+        Fire(iter->entity, aim, time_offset);
       }
+    } else if (controller->Button(kFireProjectile).Value() &&
+               controller->Button(kFireProjectile).HasChanged()) {
+      Fire(iter->entity, controller->last_position(), 0.0f);
     }
   }
 }
 
+void PlayerComponent::Fire(corgi::EntityRef& source, const mathfu::vec2i& aim,
+                           float time_offset) {
+  SpawnProjectile(source, aim, time_offset);
+
+  GraphData* graph_data = Data<GraphData>(source);
+  if (graph_data) {
+    graph_data->broadcaster.BroadcastEvent(kOnFireEventId);
+  }
+}
+
 void PlayerComponent::AddFromRawData(corgi::EntityRef& entity,
                                      const void* /*raw_data*/) {
   AddEntity(entity);
@@ -95,7 +136,9 @@ mathfu::vec3 PlayerComponent::RandomProjectileAngularVelocity() const {
   return angle * sign;
 }
 
-corgi::EntityRef PlayerComponent::SpawnProjectile(corgi::EntityRef source) {
+corgi::EntityRef PlayerComponent::SpawnProjectile(corgi::EntityRef source,
+                                                  const mathfu::vec2i& aim,
+                                                  float time_offset) {
   const SushiConfig* current_sushi = static_cast<const SushiConfig*>(
       entity_manager_->GetComponent<ServicesComponent>()
           ->world()
@@ -119,7 +162,7 @@ corgi::EntityRef PlayerComponent::SpawnProjectile(corgi::EntityRef source) {
   transform_data->position =
       transform_component->WorldPosition(source) +
       mathfu::kAxisZ3f * config_->projectile_height_offset();
-  auto forward = CalculateProjectileDirection(source);
+  auto forward = CalculateProjectileDirection(source, aim);
   auto velocity = current_sushi->speed() * forward +
                   current_sushi->upkick() * mathfu::kAxisZ3f;
   transform_data->position +=
@@ -131,6 +174,10 @@ corgi::EntityRef PlayerComponent::SpawnProjectile(corgi::EntityRef source) {
   auto raft_rail = raft_entity ? Data<RailDenizenData>(raft_entity) : nullptr;
   if (raft_rail != nullptr) velocity += raft_rail->Velocity();
 
+  // Start the projectile where it would be had it been thrown at the moment
+  // of the press, rather than at this update.
+  transform_data->position += velocity * time_offset;
+
   physics_data->SetVelocity(velocity);
   physics_data->SetAngularVelocity(RandomProjectileAngularVelocity());
   auto physics_component = entity_manager_->GetComponent<PhysicsComponent>();
@@ -141,24 +188,24 @@ corgi::EntityRef PlayerComponent::SpawnProjectile(corgi::EntityRef source) {
   // TODO: Preferably, this should be a step in the entity creation.
   transform_component->UpdateChildLinks(projectile);
 
-  Data<AttributesData>(source)->attributes[AttributeDef_ProjectilesFired]++;
+  entity_manager_->GetComponent<AttributesComponent>()->IncrementAttribute(
+      source, AttributeDef_ProjectilesFired, 1.0f);
 
   return corgi::EntityRef();
 }
 
 mathfu::vec3 PlayerComponent::CalculateProjectileDirection(
-    corgi::EntityRef source) const {
-  PlayerData* player_data = Data<PlayerData>(source);
+    corgi::EntityRef source, const mathfu::vec2i& aim) const {
   TransformComponent* transform_component =
       entity_manager_->GetComponent<TransformComponent>();
   auto forward = transform_component->WorldOrientation(source).Inverse() *
                  mathfu::kAxisY3f;
   const Camera* camera =
       entity_manager_->GetComponent<ServicesComponent>()->camera();
-  // Use the last position from the controller to determine the offset and
-  // direction of the projectile. In Cardboard mode this should be ignored,
-  // as we always want to fire down the center.
-  if (player_data->input_controller()->last_position().x >= 0 &&
+  // Use the aim position to determine the offset and direction of the
+  // projectile. In Cardboard mode this should be ignored, as we always want
+  // to fire down the center.
+  if (aim.x >= 0 &&
       camera != nullptr &&
       entity_manager_->GetComponent<ServicesComponent>()
               ->world()
@@ -174,7 +221,7 @@ mathfu::vec3 PlayerComponent::CalculateProjectileDirection(
     float fov_x_tan = fov_y_tan * camera->viewport_resolution().x /
                       camera->viewport_resolution().y;
     const mathfu::vec2 fov_tan(fov_x_tan, -fov_y_tan);
-    const mathfu::vec2 touch(player_data->input_controller()->last_position());
+    const mathfu::vec2 touch(aim);
     const mathfu::vec2 offset = fov_tan * (touch / screen_size - 0.5f);
 
     auto far_vec = camera->up() * offset.y + camera->Right() * offset.x;
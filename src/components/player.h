@@ -16,12 +16,14 @@
 #define FPL_ZOOSHI_COMPONENTS_PLAYER_H_
 
 #include <set>
+#include <vector>
 
 #include "breadboard/event.h"
 #include "components_generated.h"
 #include "config_generated.h"
 #include "corgi/component.h"
 #include "inputcontrollers/base_player_controller.h"
+#include "inputcontrollers/input_events.h"
 #include "mathfu/constants.h"
 #include "mathfu/glsl_mappings.h"
 #include "pindrop/pindrop.h"
@@ -72,16 +74,26 @@ class PlayerComponent : public corgi::Component<PlayerData> {
   virtual void UpdateAllEntities(corgi::WorldTime delta_time);
   virtual void InitEntity(corgi::EntityRef& entity);
 
-  corgi::EntityRef SpawnProjectile(corgi::EntityRef source);
-  mathfu::vec3 CalculateProjectileDirection(corgi::EntityRef source) const;
+  // Throw a projectile from `source`, aimed at the screen position `aim`, or
+  // straight ahead if `aim` is negative. `time_offset` is how many seconds
+  // ago the throw was made; the projectile starts where it would be by now.
+  corgi::EntityRef SpawnProjectile(corgi::EntityRef source,
+                                   const mathfu::vec2i& aim,
+                                   float time_offset);
+  mathfu::vec3 CalculateProjectileDirection(corgi::EntityRef source,
+                                            const mathfu::vec2i& aim) const;
 
   void set_state(PlayerState state) { state_ = state; }
 
  private:
   mathfu::vec3 RandomProjectileAngularVelocity() const;
+  void Fire(corgi::EntityRef& source, const mathfu::vec2i& aim,
+            float time_offset);
 
   const Config* config_;
   PlayerState state_;
+  // Pointer presses taken off the input event queue this update.
+  std::vector<InputEvent> presses_;
 };
 
 }  // zooshi
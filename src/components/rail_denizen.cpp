@@ -35,7 +35,6 @@
 #include "motive/init.h"
 #include "rail_def_generated.h"
 #include "scene_lab/scene_lab.h"
-#include "scene_lab/corgi/corgi_adapter.h"
 
 using mathfu::vec3;
 using corgi::component_library::GraphData;
@@ -54,16 +53,6 @@ using corgi::component_library::TransformData;
 using corgi::component_library::TransformComponent;
 using scene_lab::SceneLab;
 
-void Rail::Positions(float delta_time,
-                     std::vector<mathfu::vec3_packed>* positions) const {
-  const size_t num_positions =
-      static_cast<size_t>(std::floor(EndTime() / delta_time)) + 1;
-  positions->resize(num_positions);
-
-  motive::CompactSpline::BulkYs<3>(Splines(), 0.0f, delta_time, num_positions,
-                                   &(*positions)[0]);
-}
-
 vec3 Rail::PositionCalculatedSlowly(float time) const {
   vec3 position;
   for (int i = 0; i < kDimensions; ++i) {
@@ -106,19 +95,7 @@ void RailDenizenComponent::Init() {
   SceneLab* scene_lab = services->scene_lab();
   // Only set up callbacks if we actually have a Scene Lab.
   if (scene_lab) {
-    scene_lab->AddOnUpdateEntityCallback(
-        [this](const scene_lab::GenericEntityId& id) {
-          // Use CorgiAdapter to convert GenericEntityId to corgi::EntityRef.
-          corgi::EntityRef entity =
-              static_cast<scene_lab_corgi::CorgiAdapter*>(
-                  entity_manager_->GetComponent<ServicesComponent>()
-                      ->scene_lab()
-                      ->entity_system_adapter())
-                  ->GetEntityRef(id);
-          UpdateRailNodeData(entity);
-        });
     scene_lab->AddOnEnterEditorCallback([this]() { OnEnterEditor(); });
-    scene_lab->AddOnExitEditorCallback([this]() { PostLoadFixup(); });
   }
 }
 
@@ -310,16 +287,21 @@ void RailDenizenComponent::InitEntity(corgi::EntityRef& entity) {
   entity_manager_->AddEntityToComponent<TransformComponent>(entity);
 }
 
-void RailDenizenComponent::UpdateRailNodeData(corgi::EntityRef entity) {
-  const RailNodeData* node_data =
-      entity_manager_->GetComponentData<RailNodeData>(entity);
-  if (node_data != nullptr) {
-    const std::string& rail_name = node_data->rail_name;
-    for (auto iter = begin(); iter != end(); ++iter) {
-      const RailDenizenData* rail_denizen_data = GetComponentData(iter->entity);
-      if (rail_denizen_data->rail_name == rail_name) {
-        InitializeRail(iter->entity);
-      }
+void RailDenizenComponent::RebuildRail(const std::string& rail_name) {
+  RailManager* rail_manager =
+      entity_manager_->GetComponent<ServicesComponent>()->rail_manager();
+  const Rail* rail =
+      rail_manager->GetRailFromComponents(rail_name.c_str(), entity_manager_);
+  if (rail == nullptr) return;
+
+  // ChangeRail() only moves enabled denizens over, so restart every denizen
+  // on the rail, including the ones (like patrons) that are waiting.
+  motive::MotiveEngine& engine =
+      entity_manager_->GetComponent<AnimationComponent>()->engine();
+  for (auto iter = begin(); iter != end(); ++iter) {
+    RailDenizenData* rail_denizen_data = GetComponentData(iter->entity);
+    if (rail_denizen_data->rail_name == rail_name) {
+      rail_denizen_data->Initialize(*rail, engine);
     }
   }
 }
@@ -327,19 +309,23 @@ void RailDenizenComponent::UpdateRailNodeData(corgi::EntityRef entity) {
 void RailDenizenComponent::PostLoadFixup() {
   for (auto iter = component_data_.begin(); iter != component_data_.end();
        ++iter) {
-    RailDenizenData* rail_data = Data<RailDenizenData>(iter->entity);
-    if (rail_data->inherit_transform_data) {
-      TransformData* transform_data = Data<TransformData>(iter->entity);
-      rail_data->rail_offset =
-          transform_data->position + rail_data->internal_rail_offset;
-      rail_data->rail_orientation =
-          transform_data->orientation * rail_data->internal_rail_orientation;
-      rail_data->rail_scale =
-          transform_data->scale * rail_data->internal_rail_scale;
-    }
+    EntityPostLoadFixup(iter->entity);
   }
 }
 
+void RailDenizenComponent::EntityPostLoadFixup(corgi::EntityRef& entity) {
+  RailDenizenData* rail_data = GetComponentData(entity);
+  if (rail_data == nullptr || !rail_data->inherit_transform_data) return;
+
+  TransformData* transform_data = Data<TransformData>(entity);
+  rail_data->rail_offset =
+      transform_data->position + rail_data->internal_rail_offset;
+  rail_data->rail_orientation =
+      transform_data->orientation * rail_data->internal_rail_orientation;
+  rail_data->rail_scale =
+      transform_data->scale * rail_data->internal_rail_scale;
+}
+
 void RailDenizenComponent::OnEnterEditor() {
   for (auto iter = component_data_.begin(); iter != component_data_.end();
        ++iter) {
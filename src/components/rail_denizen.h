@@ -123,10 +123,16 @@ class RailDenizenComponent : public corgi::Component<RailDenizenData> {
   virtual void UpdateAllEntities(corgi::WorldTime delta_time);
   virtual void InitEntity(corgi::EntityRef& entity);
 
-  void UpdateRailNodeData(corgi::EntityRef entity);
+  // Rebuild the rail `rail_name` from its rail nodes, and restart every
+  // denizen that follows it. Builds the rail once, however many denizens
+  // are on it.
+  void RebuildRail(const std::string& rail_name);
 
   // This needs to be called after the entities have been loaded from data.
   void PostLoadFixup();
+  // The same, for a single entity loaded after the rest of the level. Does
+  // nothing if `entity` is not a rail denizen.
+  void EntityPostLoadFixup(corgi::EntityRef& entity);
 
   // When a Rail is reloaded, we need to reinitialize any data that uses it.
   void ChangeRail(const Rail* old_rail, const Rail* new_rail);
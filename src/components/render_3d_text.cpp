@@ -130,29 +130,13 @@ void Render3dTextComponent::Render(const EntityRef& entity,
     // Create FlatUI in 3D space.
     flatui::Run(*services_->asset_manager(), *services_->font_manager(),
                 *services_->input_system(), [&]() {
-                  const vec2i window_size =
-                      services_->asset_manager()->renderer().window_size();
-                  const float aspect_ratio =
-                      static_cast<float>(window_size.x) /
-                      static_cast<float>(window_size.y);
-
                   flatui::SetDepthTest(true);
-                  flatui::UseExistingProjection(
-                      vec2i(static_cast<int>(render_3d_text_data->canvas_size *
-                                             aspect_ratio),
-                            render_3d_text_data->canvas_size));
-                  flatui::StartGroup(flatui::kLayoutOverlay);
-                  {
-                    flatui::PositionGroup(flatui::kAlignCenter,
-                                          flatui::kAlignCenter,
-                                          mathfu::kZeros2f);
-                    {
-                      flatui::SetTextFont(render_3d_text_data->font.c_str());
-                      flatui::Label(render_3d_text_data->text.c_str(),
-                                    render_3d_text_data->label_size);
-                    }
-                  }
-                  flatui::EndGroup();
+                  Layout3dText(
+                      services_->asset_manager()->renderer().window_size(),
+                      render_3d_text_data->canvas_size,
+                      render_3d_text_data->font.c_str(),
+                      render_3d_text_data->text.c_str(),
+                      render_3d_text_data->label_size);
                 });
   }
 }
@@ -171,5 +155,21 @@ void Render3dTextComponent::SetModelViewProjectionMatrix(
   services_->asset_manager()->renderer().set_model_view_projection(mvp);
 }
 
+void Layout3dText(const vec2i& window_size, int canvas_size, const char* font,
+                  const char* text, float label_size) {
+  const float aspect_ratio =
+      static_cast<float>(window_size.x) / static_cast<float>(window_size.y);
+  flatui::UseExistingProjection(
+      vec2i(static_cast<int>(canvas_size * aspect_ratio), canvas_size));
+  flatui::StartGroup(flatui::kLayoutOverlay);
+  {
+    flatui::PositionGroup(flatui::kAlignCenter, flatui::kAlignCenter,
+                          mathfu::kZeros2f);
+    flatui::SetTextFont(font);
+    flatui::Label(text, label_size);
+  }
+  flatui::EndGroup();
+}
+
 }  // zooshi
 }  // fpl
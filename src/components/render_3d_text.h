@@ -173,6 +173,19 @@ class Render3dTextComponent : public corgi::Component<Render3dTextData> {
   ServicesComponent* services_;
 };
 
+/// @brief Lay out `text` the way Render3dTextComponent draws it: centered on a
+/// FlatUI canvas `canvas_size` units high, widened to the window's aspect
+/// ratio. Must be called from inside `flatui::Run()`.
+///
+/// @param[in] window_size The size of the window the text is drawn in.
+/// @param[in] canvas_size The height of the canvas, as in Render3dTextData.
+/// @param[in] font The relative path to the font file.
+/// @param[in] text The text to lay out.
+/// @param[in] label_size The vertical size of the text, as in
+/// Render3dTextData.
+void Layout3dText(const mathfu::vec2i& window_size, int canvas_size,
+                  const char* font, const char* text, float label_size);
+
 }  // zooshi
 }  // fpl
 
@@ -14,6 +14,8 @@
 
 #include "components/river.h"
 #include <math.h>
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include "common.h"
 #include "components/rail_denizen.h"
@@ -26,7 +28,7 @@
 #include "corgi_component_library/transform.h"
 #include "fplbase/debug_markers.h"
 #include "fplbase/utilities.h"
-#include "scene_lab/scene_lab.h"
+#include "frame_arena.h"
 #include "world.h"
 
 using mathfu::vec2;
@@ -48,30 +50,10 @@ namespace zooshi {
 using corgi::component_library::PhysicsComponent;
 using corgi::component_library::RenderMeshComponent;
 using corgi::component_library::RenderMeshData;
-using scene_lab::SceneLab;
 
 static const size_t kNumIndicesPerQuad = 6;
 
-// A vertex definition specific to normalmapping with colors.
-struct NormalMappedColorVertex {
-  vec3_packed pos;
-  vec2_packed tc;
-  vec3_packed norm;
-  vec4_packed tangent;
-  unsigned char color[4];
-};
-
-void RiverComponent::Init() {
-  auto services = entity_manager_->GetComponent<ServicesComponent>();
-  SceneLab* scene_lab = services->scene_lab();
-  if (scene_lab) {
-    scene_lab->AddOnUpdateEntityCallback(
-        [this](const scene_lab::GenericEntityId& /*entity*/) {
-          TriggerRiverUpdate();
-        });
-  }
-  river_offset_ = 0;
-}
+void RiverComponent::Init() { river_offset_ = 0; }
 
 void RiverComponent::AddFromRawData(corgi::EntityRef& entity,
                                     const void* raw_data) {
@@ -100,15 +82,17 @@ void RiverComponent::UpdateAllEntities(corgi::WorldTime /*delta_time*/) {
 }
 
 void RiverComponent::TriggerRiverUpdate() {
-  // TODO - it would be nice if this only updated the river that we were editing
-  // (instead of marking all rivers as needing an update) but due to how river
-  // edit nodes interact with the river mesh, that's tricky.
   for (auto iter = begin(); iter != end(); ++iter) {
     RiverData* river_data = Data<RiverData>(iter->entity);
     river_data->render_mesh_needs_update_ = true;
   }
 }
 
+void RiverComponent::TriggerRiverUpdate(const corgi::EntityRef& river) {
+  RiverData* river_data = GetComponentData(river);
+  if (river_data != nullptr) river_data->render_mesh_needs_update_ = true;
+}
+
 corgi::ComponentInterface::RawDataUniquePtr RiverComponent::ExportRawData(
     const corgi::EntityRef& entity) const {
   const RiverData* data = GetComponentData(entity);
@@ -128,6 +112,26 @@ corgi::ComponentInterface::RawDataUniquePtr RiverComponent::ExportRawData(
   return fbb.ReleaseBufferPointer();
 }
 
+size_t RiverComponent::MeshBytes() {
+  size_t bytes = 0;
+  for (auto iter = begin(); iter != end(); ++iter) {
+    bytes += iter->data.mesh_bytes;
+  }
+  return bytes;
+}
+
+size_t RiverComponent::CollisionMeshBytes() {
+  // Bullet's triangle mesh stores three padded vertices and three indices for
+  // every triangle.
+  static const size_t kBytesPerTriangle =
+      3 * 4 * sizeof(float) + 3 * sizeof(int);
+  size_t triangles = 0;
+  for (auto iter = begin(); iter != end(); ++iter) {
+    triangles += iter->data.collision_triangles;
+  }
+  return triangles * kBytesPerTriangle;
+}
+
 // Iterate through the river meshes and update any of them that need to be
 // regenerated.  Split out into a separate function so it can be called from
 // the render thread.  (Warning:  Crashes if you try to call it on the main
@@ -141,85 +145,57 @@ void RiverComponent::UpdateRiverMeshes() {
   PopDebugMarker();
 }
 
-// Generates the actual mesh for the river, and adds it to this entitiy's
-// rendermesh component.
-void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
-  static const fplbase::Attribute kMeshFormat[] = {
-      fplbase::kPosition3f, fplbase::kTexCoord2f, fplbase::kNormal3f,
-      fplbase::kTangent4f, fplbase::kEND};
-  static const fplbase::Attribute kBankMeshFormat[] = {
-      fplbase::kPosition3f, fplbase::kTexCoord2f, fplbase::kNormal3f,
-      fplbase::kTangent4f,  fplbase::kColor4ub,   fplbase::kEND};
-  std::vector<vec3_packed> track;
-  const RiverConfig* river = entity_manager_->GetComponent<ServicesComponent>()
-                                 ->world()
-                                 ->CurrentLevel()
-                                 ->river_config();
-
-  RiverData* river_data = Data<RiverData>(entity);
-  river_data->render_mesh_needs_update_ = false;
-
-  // Initialize the static mesh that will be made around the river banks.
-  auto* physics_component = entity_manager_->GetComponent<PhysicsComponent>();
-  physics_component->InitStaticMesh(entity);
-
-  Rail* rail = entity_manager_->GetComponent<ServicesComponent>()
-                   ->rail_manager()
-                   ->GetRailFromComponents(river_data->rail_name.c_str(),
-                                           entity_manager_);
-
-  // Generate the spline data and store it in our track vector:
-  rail->Positions(river->spline_stepsize(), &track);
-
-  fplbase::AssetManager* asset_manager =
-      entity_manager_->GetComponent<ServicesComponent>()->asset_manager();
-
-  const size_t num_bank_contours = river->default_banks()->Length();
+void BuildRiverGeometry(const RiverConfig& river, const vec3_packed* track,
+                        size_t segment_count, bool wraps,
+                        const FrameVector<bool>& single_texture_zones,
+                        unsigned int random_seed, RiverGeometry* geometry) {
+  const size_t num_bank_contours = river.default_banks()->Length();
   const size_t num_bank_quads = num_bank_contours - 2;
-  const size_t river_idx = river->river_index();
-  const size_t segment_count = track.size();
+  const size_t river_idx = river.river_index();
   const size_t river_vert_max = segment_count * 2;
   const size_t river_index_max = (segment_count - 1) * kNumIndicesPerQuad;
   const size_t bank_vert_max = segment_count * num_bank_contours;
   const size_t bank_index_max =
       (segment_count - 1) * kNumIndicesPerQuad * num_bank_quads;
   assert(num_bank_contours >= 2 && river_idx < num_bank_contours - 1);
-  const unsigned int num_zones = river->zones()->Length();
+  const unsigned int num_zones = river.zones()->Length();
 
-  // Need to allocate some space to plan out our mesh in:
-  std::vector<NormalMappedVertex> river_verts(river_vert_max);
+  // Need to allocate some space to plan out our mesh in.
+  FrameVector<NormalMappedVertex>& river_verts = geometry->river_verts;
   river_verts.clear();
-  std::vector<unsigned short> river_indices(river_index_max);
+  river_verts.reserve(river_vert_max);
+  FrameVector<unsigned short>& river_indices = geometry->river_indices;
   river_indices.clear();
+  river_indices.reserve(river_index_max);
 
-  std::vector<NormalMappedColorVertex> bank_verts(bank_vert_max);
+  FrameVector<NormalMappedColorVertex>& bank_verts = geometry->bank_verts;
   bank_verts.clear();
-  std::vector<unsigned short> bank_indices(bank_index_max);
+  bank_verts.reserve(bank_vert_max);
+  FrameVector<unsigned short>& bank_indices = geometry->bank_indices;
   bank_indices.clear();
-  // Use one set of bank vertices for the entire riverbank, but separate out
-  // the zones via indices, so we can use different materials (and possibly
-  // shaders) per zone. We still keep bank_indices for the normal calculation,
-  // though.
-  std::vector<std::vector<unsigned short>> bank_indices_by_zone;
+  bank_indices.reserve(bank_index_max);
+  FrameVector<FrameVector<unsigned short>>& bank_indices_by_zone =
+      geometry->bank_indices_by_zone;
+  bank_indices_by_zone.clear();
   bank_indices_by_zone.resize(num_zones);
 
-  std::vector<unsigned int> bank_zones;  // indexed by segment
+  FrameVector<unsigned int> bank_zones;  // indexed by segment
   bank_zones.resize(segment_count, 0);   // default of 0
   unsigned int zone_id = 0;
 
   // TODO: Use a local random number generator. Resetting the global random
   //       number generator is not a nice. Also, there's no guarantee that
   //       mathfu::Random will continue to use rand().
-  srand(river_data->random_seed);
+  srand(random_seed);
 
-  std::vector<float> actual_zone_end;
+  FrameVector<float> actual_zone_end;
   actual_zone_end.resize(segment_count, 1);
   // Precalculate the actual zone end locations.
   for (size_t i = 0; i < segment_count; i++) {
     const float fraction =
         static_cast<float>(i) / static_cast<float>(segment_count);
-    if (zone_id + 1 < river->zones()->Length() &&
-        fraction > river->zones()->Get(zone_id + 1)->zone_start()) {
+    if (zone_id + 1 < river.zones()->Length() &&
+        fraction > river.zones()->Get(zone_id + 1)->zone_start()) {
       actual_zone_end[zone_id] = fraction;
       zone_id = zone_id + 1;
     }
@@ -227,20 +203,18 @@ void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
   // Start over from zone 0.
   zone_id = 0;
 
-  const RiverZone* current_zone = river->zones()->Get(zone_id);
-  Material* current_bank_material =
-      asset_manager->LoadMaterial(current_zone->material()->c_str());
+  const RiverZone* current_zone = river.zones()->Get(zone_id);
   float river_width = current_zone->width() != 0 ? current_zone->width()
-                                                 : river->default_width();
+                                                 : river.default_width();
 
   // Construct the actual mesh data for the river:
-  std::vector<vec2> offsets(num_bank_contours);
+  FrameVector<vec2> offsets(num_bank_contours);
   for (size_t i = 0; i < segment_count; i++) {
     // Get the current position on the track, and the normal (to the side).
     vec3 track_delta;
     if (i > 0) {
       track_delta = vec3(track[i]) - vec3(track[i - 1]);
-    } else if (rail->wraps()) {
+    } else if (wraps) {
       // River track is circular.
       track_delta = vec3(track[i]) - vec3(track[segment_count - 1]);
     } else {
@@ -250,12 +224,12 @@ void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
     const vec3 track_normal =
         vec3::CrossProduct(track_delta, kAxisZ3f).Normalized();
     const vec3 track_position =
-        vec3(track[i]) + river->track_height() * kAxisZ3f;
+        vec3(track[i]) + river.track_height() * kAxisZ3f;
 
     // The river texture is tiled several times along the course of the river.
     // TODO: Change this from tile count to actual physical size for a tile.
     //       Requires that we know the total path distance.
-    const float texture_v = river->texture_tile_size() * static_cast<float>(i) /
+    const float texture_v = river.texture_tile_size() * static_cast<float>(i) /
                             static_cast<float>(segment_count);
 
     // Fraction of the river we have gone through, approximately.
@@ -264,21 +238,16 @@ void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
 
     if (fraction >= actual_zone_end[zone_id]) {
       zone_id = zone_id + 1;
-      current_zone = river->zones()->Get(zone_id);
-      // Each zone has its own texture.
-      current_bank_material =
-          asset_manager->LoadMaterial(current_zone->material()->c_str());
+      current_zone = river.zones()->Get(zone_id);
       // Each zone has its own river width.
       river_width = current_zone->width() != 0 ? current_zone->width()
-                                               : river->default_width();
-      current_bank_material = asset_manager->LoadMaterial(
-          river->zones()->Get(zone_id)->material()->c_str());
+                                               : river.default_width();
     }
     bank_zones[i] = zone_id;
     float zone_start = zone_id == 0 ? 0 : actual_zone_end[zone_id - 1];
     float zone_end = actual_zone_end[zone_id];
     float within_fraction = (fraction - zone_start) / (zone_end - zone_start);
-    if (current_bank_material->textures().size() == 1) {
+    if (single_texture_zones[zone_id]) {
       // Ensure we stay continuous with transitional zones.
       within_fraction = within_fraction < 0.5f ? 1.0f : 0.0f;
     }
@@ -296,7 +265,7 @@ void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
       flatbuffers::uoffset_t index = static_cast<flatbuffers::uoffset_t>(j);
       const RiverBankContour* b = (current_zone->banks() != nullptr)
                                       ? current_zone->banks()->Get(index)
-                                      : river->default_banks()->Get(index);
+                                      : river.default_banks()->Get(index);
       offsets[j] =
           vec2(mathfu::Lerp(b->x_min(), b->x_max(), mathfu::Random<float>()),
                mathfu::Lerp(b->z_min(), b->z_max(), mathfu::Random<float>()));
@@ -347,7 +316,7 @@ void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
     }
 
     // Force the beginning and end to line up in their geometry:
-    if (i == segment_count - 1 && rail->wraps()) {
+    if (i == segment_count - 1 && wraps) {
       for (size_t j = 0; j < num_bank_contours; j++)
         bank_verts[bank_verts.size() - (8 - j)].pos = bank_verts[j].pos;
     }
@@ -373,7 +342,7 @@ void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
   // list to represent this segment.
   //
   for (size_t i = 0; i < segment_count - 1; i++) {
-    auto make_quad = [&](std::vector<unsigned short>& indices, int base_index,
+    auto make_quad = [&](FrameVector<unsigned short>& indices, int base_index,
                          int off1, int off2) {
       indices.push_back(static_cast<unsigned short>(base_index + off1));
       indices.push_back(static_cast<unsigned short>(base_index + off1 + 1));
@@ -402,17 +371,6 @@ void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
       int offset2 = static_cast<int>(num_bank_contours + j);
       make_quad(bank_indices, base_index, offset1, offset2);
       make_quad(bank_indices_by_zone[zone], base_index, offset1, offset2);
-
-      // Add the same triangles to the static mesh associated with the entity.
-      physics_component->AddStaticMeshTriangle(
-          entity, vec3(bank_verts[base_index + offset1].pos),
-          vec3(bank_verts[base_index + offset1 + 1].pos),
-          vec3(bank_verts[base_index + offset2].pos));
-
-      physics_component->AddStaticMeshTriangle(
-          entity, vec3(bank_verts[base_index + offset2].pos),
-          vec3(bank_verts[base_index + offset1 + 1].pos),
-          vec3(bank_verts[base_index + offset2 + 1].pos));
     }
   }
 
@@ -426,6 +384,92 @@ void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
                                static_cast<int>(bank_verts.size()),
                                static_cast<int>(bank_indices.size()));
 
+  // We don't want to keep the random number generator set to the same
+  // value every time we generate the river, so reset the seed back to time.
+  srand(static_cast<unsigned int>(time(nullptr)));
+}
+
+// Generates the actual mesh for the river, and adds it to this entitiy's
+// rendermesh component.
+void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
+  static const fplbase::Attribute kMeshFormat[] = {
+      fplbase::kPosition3f, fplbase::kTexCoord2f, fplbase::kNormal3f,
+      fplbase::kTangent4f, fplbase::kEND};
+  static const fplbase::Attribute kBankMeshFormat[] = {
+      fplbase::kPosition3f, fplbase::kTexCoord2f, fplbase::kNormal3f,
+      fplbase::kTangent4f,  fplbase::kColor4ub,   fplbase::kEND};
+  FrameVector<vec3_packed> track;
+  const RiverConfig* river = entity_manager_->GetComponent<ServicesComponent>()
+                                 ->world()
+                                 ->CurrentLevel()
+                                 ->river_config();
+
+  RiverData* river_data = Data<RiverData>(entity);
+  river_data->render_mesh_needs_update_ = false;
+
+  // Initialize the static mesh that will be made around the river banks.
+  auto* physics_component = entity_manager_->GetComponent<PhysicsComponent>();
+  physics_component->InitStaticMesh(entity);
+
+  Rail* rail = entity_manager_->GetComponent<ServicesComponent>()
+                   ->rail_manager()
+                   ->GetRailFromComponents(river_data->rail_name.c_str(),
+                                           entity_manager_);
+
+  // Generate the spline data and store it in our track vector. Bank
+  // vertices are indexed with 16-bit indices, so very long rails are sampled
+  // more coarsely to keep them addressable.
+  const size_t max_segments =
+      std::numeric_limits<unsigned short>::max() /
+      river->default_banks()->Length();
+  const float step_size = std::max(
+      river->spline_stepsize(),
+      rail->EndTime() / static_cast<float>(max_segments - 1));
+  if (step_size != river->spline_stepsize()) {
+    fplbase::LogInfo("River rail %s is too long; sampling every %.0f ms",
+                     river_data->rail_name.c_str(), step_size);
+  }
+  rail->Positions(step_size, &track);
+
+  fplbase::AssetManager* asset_manager =
+      entity_manager_->GetComponent<ServicesComponent>()->asset_manager();
+
+  // Zones whose bank material has a single texture don't blend into the
+  // next zone.
+  const unsigned int num_zones = river->zones()->Length();
+  FrameVector<bool> single_texture_zones(num_zones);
+  for (unsigned int zone = 0; zone < num_zones; zone++) {
+    Material* bank_material = asset_manager->LoadMaterial(
+        river->zones()->Get(zone)->material()->c_str());
+    single_texture_zones[zone] = bank_material->textures().size() == 1;
+  }
+
+  // All of the geometry is scratch that is copied into the Mesh objects
+  // below, so it comes from the frame arena rather than the heap.
+  RiverGeometry geometry;
+  BuildRiverGeometry(*river, track.data(), track.size(), rail->wraps(),
+                     single_texture_zones, river_data->random_seed,
+                     &geometry);
+  const FrameVector<NormalMappedVertex>& river_verts = geometry.river_verts;
+  const FrameVector<unsigned short>& river_indices = geometry.river_indices;
+  const FrameVector<NormalMappedColorVertex>& bank_verts = geometry.bank_verts;
+  const FrameVector<unsigned short>& bank_indices = geometry.bank_indices;
+
+  // Add the bank triangles to the static mesh associated with the entity.
+  for (size_t i = 0; i + 2 < bank_indices.size(); i += 3) {
+    physics_component->AddStaticMeshTriangle(
+        entity, vec3(bank_verts[bank_indices[i]].pos),
+        vec3(bank_verts[bank_indices[i + 1]].pos),
+        vec3(bank_verts[bank_indices[i + 2]].pos));
+  }
+
+  river_data->mesh_bytes =
+      river_verts.size() * sizeof(NormalMappedVertex) +
+      river_indices.size() * sizeof(unsigned short) +
+      num_zones * bank_verts.size() * sizeof(NormalMappedColorVertex) +
+      bank_indices.size() * sizeof(unsigned short);
+  river_data->collision_triangles = bank_indices.size() / 3;
+
   // Load the material from files.
   Material* river_material =
       asset_manager->LoadMaterial(river->material()->c_str());
@@ -464,9 +508,10 @@ void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
         new Mesh(bank_verts.data(), static_cast<int>(bank_verts.size()),
                  sizeof(NormalMappedColorVertex), kBankMeshFormat);
 
-    bank_mesh->AddIndices(bank_indices_by_zone[zone].data(),
-                          static_cast<int>(bank_indices_by_zone[zone].size()),
-                          bank_material);
+    const FrameVector<unsigned short>& zone_indices =
+        geometry.bank_indices_by_zone[zone];
+    bank_mesh->AddIndices(zone_indices.data(),
+                          static_cast<int>(zone_indices.size()), bank_material);
     if (!river_data->banks[zone]) {
       // Now we make a new entity to hold the bank mesh.
       river_data->banks[zone] = entity_manager_->AllocateNewEntity();
@@ -482,7 +527,7 @@ void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
 
     RenderMeshData* child_render_data =
         Data<RenderMeshData>(river_data->banks[zone]);
-    if (bank_material->textures().size() == 1) {
+    if (single_texture_zones[zone]) {
       child_render_data->shaders.push_back(
           asset_manager->LoadShader("shaders/textured_lit"));
     } else {
@@ -515,10 +560,6 @@ void RiverComponent::CreateRiverMesh(corgi::EntityRef& entity) {
   physics_component->FinalizeStaticMesh(entity, collision_type, collides_with,
                                         river->mass(), river->restitution(),
                                         user_tag);
-
-  // We don't want to keep the random number generator set to the same
-  // value every time we generate the river, so reset the seed back to time.
-  srand(static_cast<unsigned int>(time(nullptr)));
 }
 
 void RiverComponent::UpdateRiverMeshes(corgi::EntityRef entity) {
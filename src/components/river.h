@@ -17,8 +17,11 @@
 
 #include <string>
 #include <vector>
+#include "common.h"
 #include "components_generated.h"
+#include "config_generated.h"
 #include "corgi/component.h"
+#include "frame_arena.h"
 #include "fplbase/mesh.h"
 #include "mathfu/constants.h"
 #include "mathfu/glsl_mappings.h"
@@ -28,13 +31,49 @@
 namespace fpl {
 namespace zooshi {
 
+// A vertex definition specific to normalmapping with colors.
+struct NormalMappedColorVertex {
+  mathfu::vec3_packed pos;
+  mathfu::vec2_packed tc;
+  mathfu::vec3_packed norm;
+  mathfu::vec4_packed tangent;
+  unsigned char color[4];
+};
+
+// The CPU-side geometry of a river and its banks. This is scratch that gets
+// copied into Meshes, so it lives in the frame arena.
+struct RiverGeometry {
+  FrameVector<NormalMappedVertex> river_verts;
+  FrameVector<unsigned short> river_indices;
+  FrameVector<NormalMappedColorVertex> bank_verts;
+  // Indices of every bank triangle. Also the triangles of the bank's
+  // collision mesh.
+  FrameVector<unsigned short> bank_indices;
+  // Use one set of bank vertices for the entire riverbank, but separate out
+  // the zones via indices, so we can use different materials (and possibly
+  // shaders) per zone.
+  FrameVector<FrameVector<unsigned short>> bank_indices_by_zone;
+};
+
+// Builds the river and bank geometry along the `segment_count` points of
+// `track`. `single_texture_zones` holds a flag per zone of `river`, set if
+// that zone's bank material has only one texture. Uses no GL, so it can be
+// run off the render thread.
+void BuildRiverGeometry(const RiverConfig& river,
+                        const mathfu::vec3_packed* track, size_t segment_count,
+                        bool wraps,
+                        const FrameVector<bool>& single_texture_zones,
+                        unsigned int random_seed, RiverGeometry* geometry);
+
 // All the relevent data for rivers ends up tossed into other components.
 // (Mostly rendermesh at the moment.)  This will probably be less empty
 // once the river gets more animated.
 struct RiverData {
   RiverData()
       : render_mesh_needs_update_(false),
-        random_seed(static_cast<unsigned int>(rand())) {}
+        random_seed(static_cast<unsigned int>(rand())),
+        mesh_bytes(0),
+        collision_triangles(0) {}
   std::vector<corgi::EntityRef> banks;
   std::string rail_name;
   // Flag for whether this river needs its meshes updated.
@@ -42,6 +81,11 @@ struct RiverData {
   // River generation has random elements, so we seed the random number
   // generator the same way every time we reload the river.
   unsigned int random_seed;
+  // Size of the vertex and index data last generated for the river and its
+  // banks, for memory accounting.
+  size_t mesh_bytes;
+  // Number of triangles added to the bank's static collision mesh.
+  size_t collision_triangles;
 };
 
 class RiverComponent : public corgi::Component<RiverData> {
@@ -64,6 +108,15 @@ class RiverComponent : public corgi::Component<RiverData> {
 
   float river_offset() const { return river_offset_; }
 
+  // Regenerate the mesh of a single river on its next update, e.g. after its
+  // rail was edited in Scene Lab.
+  void TriggerRiverUpdate(const corgi::EntityRef& river);
+
+  // Bytes of generated render mesh data across all rivers.
+  size_t MeshBytes();
+  // Estimated bytes held by Bullet for the river bank collision meshes.
+  size_t CollisionMeshBytes();
+
  private:
   void TriggerRiverUpdate();
   void CreateRiverMesh(corgi::EntityRef& entity);
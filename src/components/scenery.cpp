@@ -49,7 +49,7 @@ void SceneryComponent::Init() {
   SceneLab* scene_lab = services->scene_lab();
   if (scene_lab) {
     scene_lab->AddOnEnterEditorCallback([this]() { ShowAll(true); });
-    scene_lab->AddOnExitEditorCallback([this]() { PostLoadFixup(); });
+    scene_lab->AddOnExitEditorCallback([this]() { ResetEntityStates(); });
   }
 }
 
@@ -72,36 +72,56 @@ corgi::ComponentInterface::RawDataUniquePtr SceneryComponent::ExportRawData(
 void SceneryComponent::InitEntity(corgi::EntityRef& /*scenery*/) {}
 
 void SceneryComponent::PostLoadFixup() {
-  const TransformComponent* transform_component =
-      entity_manager_->GetComponent<TransformComponent>();
-
   // Initialize each scenery.
   for (auto iter = component_data_.begin(); iter != component_data_.end();
        ++iter) {
-    corgi::EntityRef scenery = iter->entity;
+    EntityPostLoadFixup(iter->entity);
+  }
+}
+
+void SceneryComponent::EntityPostLoadFixup(corgi::EntityRef& scenery) {
+  CacheEntityLinks(scenery);
+  ResetEntityState(scenery);
+}
 
-    // Get reference to the first child with a rendermesh. We assume there will
-    // only be one such child.
-    SceneryData* scenery_data = Data<SceneryData>(scenery);
-    scenery_data->render_child = transform_component->ChildWithComponent(
-        scenery, RenderMeshComponent::GetComponentId());
-    assert(scenery_data->render_child);
-
-    // Add animation to the entity with the rendermesh.
-    entity_manager_->AddEntityToComponent<AnimationComponent>(
-        scenery_data->render_child);
-    AnimationData* animation_data =
-        Data<AnimationData>(scenery_data->render_child);
-    animation_data->anim_table_object = scenery_data->anim_object;
-
-    // Everything starts off-screen.
-    scenery_data->state = kSceneryHide;
-
-    // Ensure all scenery starts hidden.
-    Show(scenery, false);
+void SceneryComponent::ResetEntityStates() {
+  for (auto iter = component_data_.begin(); iter != component_data_.end();
+       ++iter) {
+    ResetEntityState(iter->entity);
   }
 }
 
+void SceneryComponent::CacheEntityLinks(corgi::EntityRef& scenery) {
+  SceneryData* scenery_data = GetComponentData(scenery);
+  if (scenery_data == nullptr) return;
+
+  // Get reference to the first child with a rendermesh. We assume there will
+  // only be one such child.
+  const TransformComponent* transform_component =
+      entity_manager_->GetComponent<TransformComponent>();
+  scenery_data->render_child = transform_component->ChildWithComponent(
+      scenery, RenderMeshComponent::GetComponentId());
+  assert(scenery_data->render_child);
+
+  // Add animation to the entity with the rendermesh.
+  entity_manager_->AddEntityToComponent<AnimationComponent>(
+      scenery_data->render_child);
+  AnimationData* animation_data =
+      Data<AnimationData>(scenery_data->render_child);
+  animation_data->anim_table_object = scenery_data->anim_object;
+}
+
+void SceneryComponent::ResetEntityState(corgi::EntityRef& scenery) {
+  SceneryData* scenery_data = GetComponentData(scenery);
+  if (scenery_data == nullptr) return;
+
+  // Everything starts off-screen.
+  scenery_data->state = kSceneryHide;
+
+  // Ensure all scenery starts hidden.
+  Show(scenery, false);
+}
+
 const RailDenizenData& SceneryComponent::Raft() const {
   const corgi::EntityRef raft =
       entity_manager_->GetComponent<ServicesComponent>()->raft_entity();
@@ -84,6 +84,12 @@ class SceneryComponent : public corgi::Component<SceneryData> {
 
   // This needs to be called after the entities have been loaded from data.
   void PostLoadFixup();
+  // The same, for a single entity loaded after the rest of the level. Does
+  // nothing if `entity` is not a scenery entity.
+  void EntityPostLoadFixup(corgi::EntityRef& entity);
+  // The part of EntityPostLoadFixup() that depends on how the scenery is put
+  // together, redone when the scenery is edited in Scene Lab.
+  void CacheEntityLinks(corgi::EntityRef& scenery);
 
   // Apply an override animation to an entity that only applies in the `Show`
   // state.
@@ -91,6 +97,9 @@ class SceneryComponent : public corgi::Component<SceneryData> {
                          SceneryState show_override);
 
  private:
+  // Hide a scenery entity until the raft comes near, as at level start.
+  void ResetEntityState(corgi::EntityRef& scenery);
+  void ResetEntityStates();
   const RailDenizenData& Raft() const;
   float PopInDistSq() const;
   float PopOutDistSq() const;
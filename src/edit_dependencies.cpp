@@ -0,0 +1,111 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "edit_dependencies.h"
+
+#include <algorithm>
+
+namespace fpl {
+namespace zooshi {
+
+void EditDependencyTracker::AddDerivedData(const std::string& key,
+                                           RebuildTime rebuild_time,
+                                           const RebuildFunction& rebuild) {
+  if (HasDerivedData(key)) return;
+  derived_indices_[key] = derived_.size();
+  derived_.push_back(DerivedData());
+  DerivedData& derived = derived_.back();
+  derived.rebuild_time = rebuild_time;
+  derived.rebuild = rebuild;
+}
+
+void EditDependencyTracker::AddDependent(std::vector<size_t>* dependents,
+                                         const std::string& key) {
+  auto it = derived_indices_.find(key);
+  if (it == derived_indices_.end()) return;
+  if (std::find(dependents->begin(), dependents->end(), it->second) ==
+      dependents->end()) {
+    dependents->push_back(it->second);
+  }
+}
+
+void EditDependencyTracker::AddEntityDependency(const std::string& derived,
+                                                const std::string& entity_id) {
+  AddDependent(&entity_dependents_[entity_id], derived);
+}
+
+void EditDependencyTracker::AddDependency(const std::string& derived,
+                                          const std::string& source) {
+  auto it = derived_indices_.find(source);
+  if (it == derived_indices_.end()) return;
+  AddDependent(&derived_[it->second].dependents, derived);
+}
+
+void EditDependencyTracker::Invalidate(size_t index) {
+  DerivedData& derived = derived_[index];
+  if (derived.invalid) return;
+  derived.invalid = true;
+  invalid_count_++;
+  for (size_t i = 0; i < derived.dependents.size(); ++i) {
+    Invalidate(derived.dependents[i]);
+  }
+}
+
+void EditDependencyTracker::InvalidateEntity(const std::string& entity_id) {
+  auto it = entity_dependents_.find(entity_id);
+  if (it == entity_dependents_.end()) return;
+  const std::vector<size_t>& dependents = it->second;
+  for (size_t i = 0; i < dependents.size(); ++i) Invalidate(dependents[i]);
+}
+
+// Depth first, so `index` lands in `order` after everything built from it.
+// The order is reversed before rebuilding.
+void EditDependencyTracker::AppendRebuildOrder(
+    size_t index, RebuildTime rebuild_time, std::vector<bool>* visited,
+    std::vector<size_t>* order) const {
+  if ((*visited)[index]) return;
+  (*visited)[index] = true;
+  const DerivedData& derived = derived_[index];
+  if (!derived.invalid || derived.rebuild_time > rebuild_time) return;
+  for (size_t i = 0; i < derived.dependents.size(); ++i) {
+    AppendRebuildOrder(derived.dependents[i], rebuild_time, visited, order);
+  }
+  order->push_back(index);
+}
+
+void EditDependencyTracker::Rebuild(RebuildTime rebuild_time) {
+  if (invalid_count_ == 0) return;
+
+  std::vector<bool> visited(derived_.size(), false);
+  std::vector<size_t> order;
+  for (size_t i = 0; i < derived_.size(); ++i) {
+    AppendRebuildOrder(i, rebuild_time, &visited, &order);
+  }
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    DerivedData& derived = derived_[*it];
+    derived.invalid = false;
+    invalid_count_--;
+    if (derived.rebuild) derived.rebuild();
+  }
+}
+
+void EditDependencyTracker::Clear() {
+  derived_.clear();
+  derived_indices_.clear();
+  entity_dependents_.clear();
+  invalid_count_ = 0;
+}
+
+}  // zooshi
+}  // fpl
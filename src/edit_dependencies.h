@@ -0,0 +1,100 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_EDIT_DEPENDENCIES_H_
+#define ZOOSHI_EDIT_DEPENDENCIES_H_
+
+#include <stddef.h>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fpl {
+namespace zooshi {
+
+// Records which derived data (rails, river meshes, cached entity links) is
+// built from which entities while Scene Lab is open, so that editing an
+// entity rebuilds only what is downstream of it instead of every river and
+// every rail in the level.
+//
+// Derived data is identified by a key, like "rail:river", and can depend on
+// entities (by their Scene Lab entity id) and on other derived data.
+// Rebuilds run in dependency order, so a river mesh is rebuilt after the rail
+// it follows.
+class EditDependencyTracker {
+ public:
+  typedef std::function<void()> RebuildFunction;
+
+  // When a piece of derived data may be rebuilt. Some data can only be
+  // rebuilt once editing is finished, because the game would fight the
+  // editor over it otherwise.
+  enum RebuildTime { kRebuildWhileEditing, kRebuildOnExit };
+
+  EditDependencyTracker() : invalid_count_(0) {}
+
+  // Register derived data. Does nothing if `key` is already registered.
+  void AddDerivedData(const std::string& key, RebuildTime rebuild_time,
+                      const RebuildFunction& rebuild);
+  bool HasDerivedData(const std::string& key) const {
+    return derived_indices_.count(key) != 0;
+  }
+
+  // `derived` is built from the entity `entity_id`.
+  void AddEntityDependency(const std::string& derived,
+                           const std::string& entity_id);
+
+  // `derived` is built from the derived data `source`.
+  void AddDependency(const std::string& derived, const std::string& source);
+
+  // Mark everything downstream of the entity as needing a rebuild.
+  void InvalidateEntity(const std::string& entity_id);
+
+  // Rebuild the invalidated data that may be rebuilt at `rebuild_time`.
+  // kRebuildOnExit rebuilds everything that is invalid.
+  void Rebuild(RebuildTime rebuild_time);
+
+  // Forget all derived data and dependencies.
+  void Clear();
+
+  size_t derived_data_count() const { return derived_.size(); }
+  size_t invalid_count() const { return invalid_count_; }
+
+ private:
+  struct DerivedData {
+    DerivedData() : rebuild_time(kRebuildWhileEditing), invalid(false) {}
+    RebuildTime rebuild_time;
+    RebuildFunction rebuild;
+    bool invalid;
+    // Indices of the derived data built from this.
+    std::vector<size_t> dependents;
+  };
+
+  void AddDependent(std::vector<size_t>* dependents, const std::string& key);
+  void Invalidate(size_t index);
+  void AppendRebuildOrder(size_t index, RebuildTime rebuild_time,
+                          std::vector<bool>* visited,
+                          std::vector<size_t>* order) const;
+
+  std::vector<DerivedData> derived_;
+  std::unordered_map<std::string, size_t> derived_indices_;
+  // Indices of the derived data built from each entity.
+  std::unordered_map<std::string, std::vector<size_t>> entity_dependents_;
+  size_t invalid_count_;
+};
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_EDIT_DEPENDENCIES_H_
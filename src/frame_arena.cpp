@@ -0,0 +1,122 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "frame_arena.h"
+
+#include <assert.h>
+#include "SDL_thread.h"
+
+#if ZOOSHI_COUNT_HEAP_ALLOCATIONS
+#include <stdlib.h>
+#include <atomic>
+#endif  // ZOOSHI_COUNT_HEAP_ALLOCATIONS
+
+namespace fpl {
+namespace zooshi {
+
+// Every allocation is rounded up to this, which satisfies the alignment of
+// any type we put in a frame container (including SIMD vectors).
+static const size_t kFrameArenaAlignment = 16;
+
+static inline size_t AlignUp(size_t size) {
+  return (size + kFrameArenaAlignment - 1) & ~(kFrameArenaAlignment - 1);
+}
+
+static SDL_TLSID CurrentArenaSlot() {
+  static const SDL_TLSID slot = SDL_TLSCreate();
+  return slot;
+}
+
+FrameArena::FrameArena(size_t capacity)
+    : buffer_(static_cast<uint8_t*>(::operator new(capacity))),
+      capacity_(capacity),
+      offset_(0),
+      high_water_mark_(0),
+      live_allocations_(0) {}
+
+FrameArena::~FrameArena() {
+  if (Current() == this) SetCurrent(nullptr);
+  ::operator delete(buffer_);
+}
+
+void* FrameArena::Allocate(size_t size) {
+  stats_.allocations++;
+  live_allocations_++;
+  const size_t aligned = AlignUp(size);
+  if (aligned > capacity_ - offset_) {
+    stats_.heap_fallbacks++;
+    return ::operator new(size);
+  }
+  void* ptr = buffer_ + offset_;
+  offset_ += aligned;
+  stats_.bytes += aligned;
+  if (offset_ > high_water_mark_) high_water_mark_ = offset_;
+  return ptr;
+}
+
+void FrameArena::Deallocate(void* ptr, size_t size) {
+  if (ptr == nullptr) return;
+  live_allocations_--;
+  uint8_t* bytes = static_cast<uint8_t*>(ptr);
+  if (bytes < buffer_ || bytes >= buffer_ + capacity_) {
+    ::operator delete(ptr);
+    return;
+  }
+  // Give the space back if this was the most recent allocation, such as a
+  // temporary freed right after use. A growing vector frees its old block
+  // after allocating the new one, so that block is only reclaimed by Reset().
+  if (bytes + AlignUp(size) == buffer_ + offset_) {
+    offset_ = static_cast<size_t>(bytes - buffer_);
+  }
+}
+
+void FrameArena::Reset() {
+  assert(live_allocations_ == 0);
+  offset_ = 0;
+  live_allocations_ = 0;
+  last_frame_stats_ = stats_;
+  stats_ = FrameArenaStats();
+}
+
+FrameArena* FrameArena::Current() {
+  return static_cast<FrameArena*>(SDL_TLSGet(CurrentArenaSlot()));
+}
+
+void FrameArena::SetCurrent(FrameArena* arena) {
+  SDL_TLSSet(CurrentArenaSlot(), arena, nullptr);
+}
+
+#if ZOOSHI_COUNT_HEAP_ALLOCATIONS
+static std::atomic<uint64_t> heap_allocation_count(0);
+
+uint64_t HeapAllocationCount() {
+  return heap_allocation_count.load(std::memory_order_relaxed);
+}
+#endif  // ZOOSHI_COUNT_HEAP_ALLOCATIONS
+
+}  // zooshi
+}  // fpl
+
+#if ZOOSHI_COUNT_HEAP_ALLOCATIONS
+void* operator new(size_t size) {
+  fpl::zooshi::heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = malloc(size != 0 ? size : 1);
+  if (ptr == nullptr) abort();
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+#endif  // ZOOSHI_COUNT_HEAP_ALLOCATIONS
@@ -0,0 +1,176 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_FRAME_ARENA_H_
+#define ZOOSHI_FRAME_ARENA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <map>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Set to 1 to count every global operator new, so that steady-state gameplay
+// can be checked for heap allocations. See HeapAllocationCount().
+#ifndef ZOOSHI_COUNT_HEAP_ALLOCATIONS
+#define ZOOSHI_COUNT_HEAP_ALLOCATIONS 0
+#endif  // ZOOSHI_COUNT_HEAP_ALLOCATIONS
+
+namespace fpl {
+namespace zooshi {
+
+// Default capacity of the arena owned by each game thread.
+static const size_t kDefaultFrameArenaSize = 1024 * 1024;
+
+// Allocation counters for one frame of one arena.
+struct FrameArenaStats {
+  FrameArenaStats() : allocations(0), bytes(0), heap_fallbacks(0) {}
+
+  // Number of allocations served, including heap fallbacks.
+  uint32_t allocations;
+  // Bytes handed out from the arena itself.
+  size_t bytes;
+  // Allocations that did not fit and went to the heap instead. Should stay
+  // at zero during gameplay; if not, the arena needs to be larger.
+  uint32_t heap_fallbacks;
+};
+
+// A linear allocator for memory that lives no longer than one frame.
+// Allocation bumps a pointer; nothing is freed until Reset(), which the
+// owning thread calls at the end of every frame. Requests that do not fit
+// fall back to the heap and are counted, so the arena can be sized to the
+// workload.
+//
+// Each thread binds its own arena with SetCurrent(). An arena must only be
+// used from the thread it is bound to.
+class FrameArena {
+ public:
+  explicit FrameArena(size_t capacity = kDefaultFrameArenaSize);
+  ~FrameArena();
+
+  void* Allocate(size_t size);
+  void Deallocate(void* ptr, size_t size);
+
+  // Release everything allocated this frame. All memory handed out since the
+  // last Reset() must have been deallocated by now.
+  void Reset();
+
+  // Counters for the frame in progress, and for the last completed frame.
+  const FrameArenaStats& stats() const { return stats_; }
+  const FrameArenaStats& last_frame_stats() const { return last_frame_stats_; }
+
+  // Largest number of bytes used in any one frame so far.
+  size_t high_water_mark() const { return high_water_mark_; }
+  size_t capacity() const { return capacity_; }
+
+  // The arena bound to the calling thread, or nullptr if none is.
+  static FrameArena* Current();
+  static void SetCurrent(FrameArena* arena);
+
+ private:
+  FrameArena(const FrameArena&);
+  FrameArena& operator=(const FrameArena&);
+
+  uint8_t* buffer_;
+  size_t capacity_;
+  size_t offset_;
+  size_t high_water_mark_;
+  int live_allocations_;
+  FrameArenaStats stats_;
+  FrameArenaStats last_frame_stats_;
+};
+
+// STL allocator that draws from the arena bound to the constructing thread.
+// If no arena is bound, it behaves like std::allocator.
+template <typename T>
+class FrameAllocator {
+ public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef FrameAllocator<U> other;
+  };
+
+  FrameAllocator() : arena_(FrameArena::Current()) {}
+  explicit FrameAllocator(FrameArena* arena) : arena_(arena) {}
+  template <typename U>
+  FrameAllocator(const FrameAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    const size_t size = n * sizeof(T);
+    void* ptr = arena_ != nullptr ? arena_->Allocate(size)
+                                  : ::operator new(size);
+    return static_cast<T*>(ptr);
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    if (arena_ != nullptr) {
+      arena_->Deallocate(ptr, n * sizeof(T));
+    } else {
+      ::operator delete(ptr);
+    }
+  }
+
+  template <typename U, typename... Args>
+  void construct(U* ptr, Args&&... args) {
+    ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+  }
+  template <typename U>
+  void destroy(U* ptr) {
+    ptr->~U();
+  }
+
+  size_t max_size() const { return static_cast<size_t>(-1) / sizeof(T); }
+
+  FrameArena* arena() const { return arena_; }
+
+ private:
+  FrameArena* arena_;
+};
+
+template <typename T, typename U>
+inline bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+template <typename T, typename U>
+inline bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b) {
+  return a.arena() != b.arena();
+}
+
+// Containers for per-frame temporaries. These must not outlive the frame.
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+template <typename K, typename V, typename Compare = std::less<K>>
+using FrameMap =
+    std::map<K, V, Compare, FrameAllocator<std::pair<const K, V>>>;
+
+#if ZOOSHI_COUNT_HEAP_ALLOCATIONS
+// Total number of global operator new calls made by the process.
+uint64_t HeapAllocationCount();
+#endif  // ZOOSHI_COUNT_HEAP_ALLOCATIONS
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_FRAME_ARENA_H_
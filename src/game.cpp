@@ -18,6 +18,7 @@
 
 #include "SDL.h"
 #include "SDL_events.h"
+#include "analytics.h"
 #include "anim_generated.h"
 #include "assets_generated.h"
 #include "audio_config_generated.h"
@@ -324,7 +325,8 @@ void Game::InitializeBreadboardModules() {
   breadboard::module_library::InitializeVecModule(&module_registry_);
 
   // Zooshi module initialization.
-  InitializeAttributesModule(&module_registry_, &world_.attributes_component);
+  InitializeAttributesModule(&module_registry_, &world_.attributes_component,
+                             &world_.graph_component);
   InitializeGpgModule(&module_registry_, &GetConfig(), &gpg_manager_);
   InitializePatronModule(&module_registry_, &world_.patron_component);
   InitializePlayerModule(&module_registry_, &world_.player_component,
@@ -359,6 +361,23 @@ class AudioEngineVolumeControl {
   pindrop::AudioEngine *audio_;
 };
 
+// Write out unsaved progress when the game goes into the background, since it
+// may then be killed without further warning.
+class SaveManagerFlushControl {
+ public:
+  SaveManagerFlushControl(SaveManager *save_manager)
+      : save_manager_(save_manager) {}
+  void operator()(void *userdata) {
+    SDL_Event *event = static_cast<SDL_Event *>(userdata);
+    if (event->type == SDL_APP_WILLENTERBACKGROUND) {
+      save_manager_->Flush();
+    }
+  }
+
+ private:
+  SaveManager *save_manager_;
+};
+
 // Initialize each member in turn. This is logically just one function, since
 // the order of initialization cannot be changed. However, it's nice for
 // debugging and readability to have each section lexographically separate.
@@ -370,6 +389,7 @@ bool Game::Initialize(const char *const binary_directory) {
 
   input_.Initialize();
   input_.AddAppEventCallback(AudioEngineVolumeControl(&audio_engine_));
+  input_.AddAppEventCallback(SaveManagerFlushControl(&save_manager_));
 #if FPLBASE_ANDROID_VR
   input_.head_mounted_display_input().EnableDeviceOrientationCorrection();
 #endif  // FPLBASE_ANDROID_VR
@@ -378,6 +398,9 @@ bool Game::Initialize(const char *const binary_directory) {
 
   if (!fplbase::ChangeToUpstreamDir(binary_directory, kAssetsDir)) return false;
 
+  // Read the save file once, up front, for everything that needs it.
+  save_manager_.Initialize(kSaveAppName);
+
   if (!LoadFile(kConfigFileName, &config_source_)) return false;
 
   if (!InitializeRenderer()) return false;
@@ -419,17 +442,64 @@ bool Game::Initialize(const char *const binary_directory) {
 #else
   firebase_app_ = firebase::App::Create(firebase::AppOptions());
 #endif  // __ANDROID__
-  admob_helper_.Initialize(*firebase_app_);
+  admob_helper_.Initialize(*firebase_app_, &remote_config_);
   firebase::analytics::Initialize(*firebase_app_);
+  RegisterAnalyticsNames(&world_.analytics);
+#if ZOOSHI_ANALYTICS_FILE_SINK
+  std::string analytics_path;
+  fplbase::GetStoragePath(kSaveAppName, &analytics_path);
+  analytics_sink_.reset(
+      new AnalyticsFileSink(analytics_path + "analytics.log"));
+#else
+  analytics_sink_.reset(new FirebaseAnalyticsSink());
+#endif  // ZOOSHI_ANALYTICS_FILE_SINK
+  world_.analytics.Initialize(analytics_sink_.get());
   firebase::invites::Initialize(*firebase_app_);
   firebase::invites::SetListener(&invites_listener_);
   firebase::messaging::Initialize(*firebase_app_, &message_listener_);
-  InitializeRemoteConfig(*firebase_app_);
+  remote_config_.Initialize(*firebase_app_, &save_manager_);
 
   world_.Initialize(GetConfig(), &input_, &asset_manager_, &world_renderer_,
                     &font_manager_, &audio_engine_, &graph_factory_, &renderer_,
                     scene_lab_.get(), &unlockable_manager_, &xp_system_,
-                    &invites_listener_, &message_listener_, &admob_helper_);
+                    &save_manager_, &invites_listener_, &message_listener_,
+                    &admob_helper_, &remote_config_, &leaderboard_);
+
+  const FrameArena *render_arena = &render_frame_arena_;
+  const FrameArena *update_arena = &update_frame_arena_;
+  world_.memory.Register("frame arenas", [render_arena, update_arena]() {
+    return render_arena->capacity() + update_arena->capacity();
+  });
+  world_.memory.SetBudgets(GetConfig().memory_budgets());
+
+  world_.stats.RegisterSampler(
+      "render arena", kStatKindBytes, [render_arena]() {
+        return static_cast<double>(render_arena->last_frame_stats().bytes);
+      });
+  world_.stats.RegisterSampler(
+      "update arena", kStatKindBytes, [update_arena]() {
+        return static_cast<double>(update_arena->last_frame_stats().bytes);
+      });
+  world_.stats.RegisterSampler(
+      "arena heap fallbacks", kStatKindCount, [render_arena, update_arena]() {
+        return static_cast<double>(
+            render_arena->last_frame_stats().heap_fallbacks +
+            update_arena->last_frame_stats().heap_fallbacks);
+      });
+#if ZOOSHI_COUNT_HEAP_ALLOCATIONS
+  uint64_t last_heap_allocations = HeapAllocationCount();
+  world_.stats.RegisterSampler(
+      "heap allocations", kStatKindCount,
+      [last_heap_allocations]() mutable {
+        const uint64_t heap_allocations = HeapAllocationCount();
+        const uint64_t delta = heap_allocations - last_heap_allocations;
+        last_heap_allocations = heap_allocations;
+        return static_cast<double>(delta);
+      });
+#endif  // ZOOSHI_COUNT_HEAP_ALLOCATIONS
+  if (GetConfig().stats_log() != nullptr) {
+    stats_logger_.Open(*GetConfig().stats_log());
+  }
 
 #if FPLBASE_ANDROID_VR
   if (fplbase::SupportsHeadMountedDisplay()) {
@@ -496,6 +566,22 @@ bool Game::Initialize(const char *const binary_directory) {
 
   gpg_manager_.Initialize(false);
 
+  const GPGConfig *gpg_config = GetConfig().gpg_config();
+  if (gpg_config != nullptr && gpg_config->fake_leaderboard() != nullptr) {
+    LogInfo("Using the fake leaderboard backend");
+    leaderboard_backend_.reset(
+        new FakeLeaderboardBackend(gpg_config->fake_leaderboard()));
+  } else {
+#ifdef USING_GOOGLE_PLAY_GAMES
+    leaderboard_backend_.reset(new GPGLeaderboardBackend(&gpg_manager_));
+#endif  // USING_GOOGLE_PLAY_GAMES
+  }
+  leaderboard_.Initialize(leaderboard_backend_.get(), &save_manager_);
+  // Fetched as soon as the player is signed in.
+  const std::string leaderboard_id =
+      LeaderboardId(gpg_config, kGPGDefaultLeaderboard);
+  if (!leaderboard_id.empty()) leaderboard_.Prefetch(leaderboard_id);
+
   auto fader_material =
       asset_manager_.FindMaterial(asset_manifest.fader_material()->c_str());
   assert(fader_material);
@@ -525,10 +611,11 @@ bool Game::Initialize(const char *const binary_directory) {
   state_machine_.AssignState(kGameStateSceneLab, &scene_lab_state_);
   state_machine_.SetCurrentStateId(kGameStateLoading);
 
+  unlockable_manager_.Initialize(&save_manager_);
   unlockable_manager_.InitializeType(UnlockableType_Sushi,
                                      config->sushi_config());
 
-  xp_system_.Initialize(config);
+  xp_system_.Initialize(config, &save_manager_);
 
 #if FPLBASE_ANDROID_VR
   if (fplbase::AndroidGetActivityName() ==
@@ -568,6 +655,7 @@ struct UpdateThreadData {
                    fplbase::Renderer *renderer_ptr,
                    fplbase::InputSystem *input_ptr,
                    pindrop::AudioEngine *audio_engine_ptr,
+                   GPGManager *gpg_manager_ptr, FrameArena *frame_arena_ptr,
                    GameSynchronization *sync_ptr)
       : game_exiting(exiting),
         world(world_ptr),
@@ -575,6 +663,8 @@ struct UpdateThreadData {
         renderer(renderer_ptr),
         input(input_ptr),
         audio_engine(audio_engine_ptr),
+        gpg_manager(gpg_manager_ptr),
+        frame_arena(frame_arena_ptr),
         sync(sync_ptr) {}
   bool *game_exiting;
   World *world;
@@ -582,6 +672,8 @@ struct UpdateThreadData {
   fplbase::Renderer *renderer;
   fplbase::InputSystem *input;
   pindrop::AudioEngine *audio_engine;
+  GPGManager *gpg_manager;
+  FrameArena *frame_arena;
   GameSynchronization *sync;
   corgi::WorldTime frame_start;
 };
@@ -606,6 +698,7 @@ static int UpdateThread(void *data) {
       nullptr;  // you might want to assign the java thread to a ThreadGroup
   jvm->AttachCurrentThread(&update_env, &args);
 #endif  // __ANDROID__
+  FrameArena::SetCurrent(rt_data->frame_arena);
 
   SDL_LockMutex(sync.updatethread_mutex_);
   while (!*(rt_data->game_exiting)) {
@@ -623,19 +716,39 @@ static int UpdateThread(void *data) {
         std::min(world_time - prev_update_time, kMaxUpdateTime);
     prev_update_time = world_time;
 
-    SystraceAsyncBegin("UpdateGameState", kUpdateGameStateCode);
-    rt_data->state_machine->AdvanceFrame(delta_time);
-    SystraceAsyncEnd("UpdateGameState", kUpdateGameStateCode);
+    StatsRegistry *stats = &rt_data->world->stats;
+    {
+      ScopedStatTimer timer(stats, kStatUpdateMs);
+      SystraceAsyncBegin("UpdateGameState", kUpdateGameStateCode);
+      rt_data->state_machine->AdvanceFrame(delta_time);
+      SystraceAsyncEnd("UpdateGameState", kUpdateGameStateCode);
+    }
+
+    {
+      ScopedStatTimer timer(stats, kStatRenderPrepMs);
+      SystraceAsyncBegin("UpdateRenderPrep", kUpdateRenderPrepCode);
+      rt_data->state_machine->RenderPrep();
+      SystraceAsyncEnd("UpdateRenderPrep", kUpdateRenderPrepCode);
+    }
 
-    SystraceAsyncBegin("UpdateRenderPrep", kUpdateRenderPrepCode);
-    rt_data->state_machine->RenderPrep();
-    SystraceAsyncEnd("UpdateRenderPrep", kUpdateRenderPrepCode);
+    {
+      ScopedStatTimer timer(stats, kStatAudioMs);
+      rt_data->audio_engine->AdvanceFrame(delta_time / 1000.0f);
+    }
 
-    rt_data->audio_engine->AdvanceFrame(delta_time / 1000.0f);
+    // Service Play Games here rather than on the render thread, so that none
+    // of its polling lands between frame submission and the vsync wait.
+    rt_data->gpg_manager->Update();
+    rt_data->world->leaderboard->Update();
+    rt_data->world->remote_config->Update();
 
     *(rt_data->game_exiting) |= rt_data->state_machine->done();
+
+    // Everything allocated from the arena this update is dead by now.
+    rt_data->frame_arena->Reset();
     SDL_UnlockMutex(sync.gameupdate_mutex_);
   }
+  FrameArena::SetCurrent(nullptr);
 
 #ifdef __ANDROID__
   jvm->DetachCurrentThread();
@@ -679,7 +792,9 @@ static int VsyncSimulatorThread(void * /*data*/) {
 void Game::Run() {
   // Start the update thread:
   UpdateThreadData rt_data(&game_exiting_, &world_, &state_machine_, &renderer_,
-                           &input_, &audio_engine_, &sync_);
+                           &input_, &audio_engine_, &gpg_manager_,
+                           &update_frame_arena_, &sync_);
+  FrameArena::SetCurrent(&render_frame_arena_);
 
   input_.AdvanceFrame(&renderer_.window_size());
   state_machine_.AdvanceFrame(16);
@@ -711,6 +826,9 @@ void Game::Run() {
   }
   int history_index = 0;
   int total_dropped_frames = 0;
+#if ZOOSHI_COUNT_HEAP_ALLOCATIONS
+  uint64_t last_heap_allocations = HeapAllocationCount();
+#endif  // ZOOSHI_COUNT_HEAP_ALLOCATIONS
 
   global_vsync_context = &sync_;
 #ifdef __ANDROID__
@@ -775,8 +893,20 @@ void Game::Run() {
     SystraceBegin("Input::AdvanceFrame()");
     input_.AdvanceFrame(&renderer_.window_size());
     game_exiting_ |= input_.exit_requested();
+    // Queue this frame's presses now, since the update thread may not run
+    // once for every input frame.
+    RecordPointerPresses(&input_, &world_.input_events);
     SystraceEnd();
 
+    // Dump a memory snapshot on demand. The update thread is parked here, so
+    // the reporters can safely read game state.
+    if (input_.GetButton(fplbase::FPLK_F6).went_down()) {
+      world_.memory.LogSnapshot("requested");
+    }
+    if (input_.GetButton(fplbase::FPLK_F5).went_down()) {
+      stats_hud_.Toggle();
+    }
+
     // Milliseconds elapsed since last update.
     rt_data.frame_start = CurrentWorldTimeSubFrame(input_);
 
@@ -792,13 +922,28 @@ void Game::Run() {
     renderer_.SetCulling(fplbase::kCullingModeBack);
     PopDebugMarker();
 
-    state_machine_.Render(&renderer_);
+    {
+      ScopedStatTimer timer(&world_.stats, kStatRenderMs);
+      state_machine_.Render(&renderer_);
+    }
     SystraceEnd();
 
+    // Publish this frame's stats while the update thread is parked.
+    world_.stats.Latch();
+    stats_logger_.Update(world_.stats);
+    world_.memory.AdvanceFrame();
+    // HandleUI() reads the menu labels after the mutex is released.
+    remote_config_.Latch();
+
     SDL_UnlockMutex(sync_.gameupdate_mutex_);
 
     SystraceBegin("StateMachine::HandleUI()");
-    state_machine_.HandleUI(&renderer_);
+    {
+      ScopedStatTimer timer(&world_.stats, kStatUiMs);
+      state_machine_.HandleUI(&renderer_);
+    }
+    stats_hud_.Render(asset_manager_, font_manager_, input_, world_.stats,
+                      GetConfig().license_font()->c_str());
     SystraceEnd();
 
     // -------------------------------------------
@@ -816,13 +961,14 @@ void Game::Run() {
     // preparing the world state for next frame.
     // -------------------------------------------
     SystraceBegin("AdvanceFrame");
-    renderer_.AdvanceFrame(input_.minimized(), input_.Time());
+    {
+      ScopedStatTimer timer(&world_.stats, kStatSwapMs);
+      renderer_.AdvanceFrame(input_.minimized(), input_.Time());
+    }
     SystraceEnd();  // AdvanceFrame
 
     SystraceEnd();  // RenderFrame
 
-    gpg_manager_.Update();
-
     // Process input device messages since the last game loop.
     // Update render window size.
     if (input_.GetButton(fplbase::FPLK_BACKQUOTE).went_down()) {
@@ -836,13 +982,33 @@ void Game::Run() {
 #endif  // DISPLAY_FRAMERATE_HISTOGRAM
 
     SystraceCounter("FrameTime", frame_time);
+    world_.stats.Set(kStatFrameMs, frame_time);
+
+    render_frame_arena_.Reset();
+    SystraceCounter("FrameArenaHeapFallbacks",
+                    static_cast<int>(
+                        render_frame_arena_.last_frame_stats().heap_fallbacks));
+#if ZOOSHI_COUNT_HEAP_ALLOCATIONS
+    // Report how many heap allocations the whole process made over the last
+    // history window. During steady-state gameplay this should be zero.
+    if (history_index == 0) {
+      const uint64_t heap_allocations = HeapAllocationCount();
+      LogInfo("Heap allocations in the last %d frames: %llu", kHistorySize,
+              static_cast<unsigned long long>(heap_allocations -
+                                              last_heap_allocations));
+      last_heap_allocations = heap_allocations;
+    }
+#endif  // ZOOSHI_COUNT_HEAP_ALLOCATIONS
   }
+  FrameArena::SetCurrent(nullptr);
   SDL_UnlockMutex(sync_.renderthread_mutex_);
 // Clean up asynchronous callbacks to prevent crashing on garbage data.
 #ifdef __ANDROID__
   fplbase::RegisterVsyncCallback(nullptr);
 #endif  // __ANDROID__
   input_.AddAppEventCallback(nullptr);
+  world_.analytics.Shutdown();
+  save_manager_.Shutdown();
 }
 
 #if DISPLAY_FRAMERATE_HISTOGRAM
@@ -25,15 +25,19 @@
 #include "corgi/entity_manager.h"
 #include "flatbuffers/flatbuffers.h"
 #include "flatui/font_manager.h"
+#include "frame_arena.h"
 #include "fplbase/asset_manager.h"
 #include "fplbase/input.h"
 #include "fplbase/renderer.h"
 #include "fplbase/utilities.h"
 #include "full_screen_fader.h"
+#include "game_stats.h"
+#include "leaderboard_service.h"
 #include "mathfu/glsl_mappings.h"
 #include "module_library/default_graph_factory.h"
 #include "pindrop/pindrop.h"
 #include "rail_def_generated.h"
+#include "save_manager.h"
 #include "states/intro_state.h"
 #include "states/loading_state.h"
 #include "states/pause_state.h"
@@ -49,6 +53,10 @@
 
 #define DISPLAY_FRAMERATE_HISTOGRAM 0
 
+// Write analytics events to a file in the storage directory instead of
+// sending them to Firebase.
+#define ZOOSHI_ANALYTICS_FILE_SINK 0
+
 #ifdef __ANDROID__
 #define FPLBASE_ENABLE_SYSTRACE 0
 #endif
@@ -138,6 +146,11 @@ class Game {
   // Mutexes/CVs used in synchronizing the render and update threads:
   GameSynchronization sync_;
 
+  // Scratch memory for per-frame temporaries, one arena per thread. Each is
+  // reset at the end of its thread's frame.
+  FrameArena render_frame_arena_;
+  FrameArena update_frame_arena_;
+
   // Hold configuration binary data.
   std::string config_source_;
 
@@ -182,6 +195,7 @@ class Game {
   InvitesListener invites_listener_;
   MessageListener message_listener_;
   AdMobHelper admob_helper_;
+  RemoteConfig remote_config_;
 
 #if DISPLAY_FRAMERATE_HISTOGRAM
   // Profiling data.
@@ -196,9 +210,16 @@ class Game {
 
   pindrop::AudioConfig* audio_config_;
 
+  // Must outlive world_, whose analytics logger delivers to it.
+  std::unique_ptr<AnalyticsSink> analytics_sink_;
+
   World world_;
   WorldRenderer world_renderer_;
 
+  // On-screen overlay and soak test log of world_.stats.
+  StatsHud stats_hud_;
+  StatsLogger stats_logger_;
+
   // Fade the screen to back and from black.
   FullScreenFader fader_;
 
@@ -212,9 +233,17 @@ class Game {
   // Google Play Game Services Manager.
   GPGManager gpg_manager_;
 
+  // Scores the player's games against their best without blocking on the
+  // network. The backend is Play Games, or a fake one selected in the config.
+  std::unique_ptr<LeaderboardBackend> leaderboard_backend_;
+  LeaderboardService leaderboard_;
+
   // Name of the optional overlay to load assets from.
   static std::string overlay_name_;
 
+  // Loads and saves XP, unlocks and settings.
+  SaveManager save_manager_;
+
   // The progression system to track unlockables.
   UnlockableManager unlockable_manager_;
 
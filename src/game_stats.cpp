@@ -0,0 +1,84 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "game_stats.h"
+
+#include <stdio.h>
+#include "flatui/flatui.h"
+#include "fplbase/debug_markers.h"
+
+namespace fpl {
+namespace zooshi {
+
+static const float kHudTextSize = 20.0f;
+static const size_t kHudLinesPerColumn = 30;
+static const mathfu::vec4 kHudTextColor(1.0f, 1.0f, 0.4f, 1.0f);
+
+void RegisterGameStats(StatsRegistry* stats) {
+  assert(stats->size() == 0);
+  stats->Register("frame ms", kStatKindMilliseconds, false);
+  stats->Register("render ms", kStatKindMilliseconds, false);
+  stats->Register("ui ms", kStatKindMilliseconds, false);
+  stats->Register("swap ms", kStatKindMilliseconds, false);
+  stats->Register("update ms", kStatKindMilliseconds, false);
+  stats->Register("render prep ms", kStatKindMilliseconds, false);
+  stats->Register("audio ms", kStatKindMilliseconds, false);
+  stats->Register("physics contacts", kStatKindCount, true);
+  assert(stats->size() == kGameStatCount);
+}
+
+void StatsHud::Render(fplbase::AssetManager& assetman,
+                      flatui::FontManager& fontman,
+                      fplbase::InputSystem& input, const StatsRegistry& stats,
+                      const char* font) {
+  if (!enabled_) return;
+  PushDebugMarker("StatsHud");
+
+  flatui::Run(assetman, fontman, input, [&]() {
+    flatui::SetTextColor(kHudTextColor);
+    flatui::SetTextFont(font);
+    flatui::StartGroup(flatui::kLayoutHorizontalTop, 20);
+    flatui::PositionGroup(flatui::kAlignLeft, flatui::kAlignTop,
+                          mathfu::vec2(10, 10));
+    for (StatId id = 0; id < stats.size(); ++id) {
+      if (id % kHudLinesPerColumn == 0) {
+        if (id != 0) flatui::EndGroup();
+        flatui::StartGroup(flatui::kLayoutVerticalLeft, 0);
+      }
+      char value[32];
+      switch (stats.kind(id)) {
+        case kStatKindMilliseconds:
+          snprintf(value, sizeof(value), "%.2f", stats.average(id));
+          break;
+        case kStatKindBytes:
+          snprintf(value, sizeof(value), "%.1fKB", stats.latched(id) / 1024.0);
+          break;
+        default:
+          snprintf(value, sizeof(value), "%.0f", stats.latched(id));
+          break;
+      }
+      line_ = stats.name(id);
+      line_ += ": ";
+      line_ += value;
+      flatui::Label(line_.c_str(), kHudTextSize);
+    }
+    if (stats.size() != 0) flatui::EndGroup();
+    flatui::EndGroup();
+  });
+
+  PopDebugMarker();
+}
+
+}  // zooshi
+}  // fpl
@@ -0,0 +1,73 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_GAME_STATS_H_
+#define ZOOSHI_GAME_STATS_H_
+
+#include <string>
+
+#include "flatui/font_manager.h"
+#include "fplbase/asset_manager.h"
+#include "fplbase/input.h"
+#include "stats_registry.h"
+
+namespace fpl {
+namespace zooshi {
+
+// Stats pushed by the game loop and gameplay code. RegisterGameStats()
+// registers them in this order, so each value is also its StatId. Sampled
+// stats (entity counts, render totals, allocations) are registered after
+// these by their owners.
+enum GameStat {
+  // Render thread phases.
+  kStatFrameMs,
+  kStatRenderMs,
+  kStatUiMs,
+  kStatSwapMs,
+  // Update thread phases.
+  kStatUpdateMs,
+  kStatRenderPrepMs,
+  kStatAudioMs,
+  // Collisions reported by the physics component this frame.
+  kStatPhysicsContacts,
+  kGameStatCount
+};
+
+// Register the stats above into `stats`, in order. Must be called before
+// anything else is registered.
+void RegisterGameStats(StatsRegistry* stats);
+
+// Draws the latched stats as a text overlay in the top-left corner.
+class StatsHud {
+ public:
+  StatsHud() : enabled_(false) {}
+
+  void Toggle() { enabled_ = !enabled_; }
+  bool enabled() const { return enabled_; }
+
+  // Call from the render thread after the frame's UI has been drawn.
+  void Render(fplbase::AssetManager& assetman, flatui::FontManager& fontman,
+              fplbase::InputSystem& input, const StatsRegistry& stats,
+              const char* font);
+
+ private:
+  bool enabled_;
+  // Reused for formatting each line.
+  std::string line_;
+};
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_GAME_STATS_H_
@@ -0,0 +1,62 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "glyph_prewarm.h"
+
+#include "components/render_3d_text.h"
+#include "config_generated.h"
+#include "flatui/flatui.h"
+#include "mathfu/constants.h"
+
+namespace fpl {
+namespace zooshi {
+
+void PrewarmGlyphs(const Config& config, fplbase::AssetManager* asset_manager,
+                   flatui::FontManager* font_manager,
+                   fplbase::InputSystem* input_system) {
+  auto prewarm = config.glyph_prewarm();
+  if (prewarm == nullptr) return;
+
+  const mathfu::vec2i window_size = asset_manager->renderer().window_size();
+  for (auto def = prewarm->begin(); def != prewarm->end(); ++def) {
+    if (def->font() == nullptr || def->sizes() == nullptr ||
+        def->characters() == nullptr) {
+      continue;
+    }
+    const char* font = def->font()->c_str();
+    const char* characters = def->characters()->c_str();
+    // Glyphs are rasterized at the label size scaled by the projection, so
+    // each projection needs its own flatui pass.
+    flatui::Run(*asset_manager, *font_manager, *input_system, [&]() {
+      // The text only has to be laid out to get its glyphs into the atlas, so
+      // draw it fully transparent.
+      flatui::SetTextColor(mathfu::kZeros4f);
+      for (auto size = def->sizes()->begin(); size != def->sizes()->end();
+           ++size) {
+        if (def->canvas_size() > 0) {
+          Layout3dText(window_size, def->canvas_size(), font, characters,
+                       *size);
+        } else {
+          flatui::StartGroup(flatui::kLayoutOverlay, 0);
+          flatui::SetTextFont(font);
+          flatui::Label(characters, *size);
+          flatui::EndGroup();
+        }
+      }
+    });
+  }
+}
+
+}  // zooshi
+}  // fpl
@@ -0,0 +1,44 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_GLYPH_PREWARM_H_
+#define ZOOSHI_GLYPH_PREWARM_H_
+
+#include "flatui/font_manager.h"
+#include "fplbase/asset_manager.h"
+#include "fplbase/input.h"
+
+namespace fpl {
+namespace zooshi {
+
+struct Config;
+
+// Lay out the text listed in the config's glyph_prewarm, fully transparent,
+// so that its glyphs are rasterized into the font atlas. Entries with a
+// canvas_size are laid out the way Render3dTextComponent draws its labels;
+// everything else at the menus' virtual resolution. Call from the render
+// thread once the fonts are loaded, e.g. while the loading screen is up.
+//
+// Laid-out text isn't cached here. FlatUI's FontManager already keeps a
+// buffer for each text, font and size it has laid out, and reuses it until
+// its glyph cache is flushed. A second cache on top would only duplicate
+// those buffers.
+void PrewarmGlyphs(const Config& config, fplbase::AssetManager* asset_manager,
+                   flatui::FontManager* font_manager,
+                   fplbase::InputSystem* input_system);
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_GLYPH_PREWARM_H_
@@ -27,6 +27,8 @@ namespace fpl {
 GPGManager::GPGManager() {
 #ifdef USING_GOOGLE_PLAY_GAMES
   state_ = kStart;
+  logged_in_ = false;
+  toggle_sign_in_requested_ = false;
   do_ui_login_ = false;
   delayed_login_ = false;
 #endif
@@ -44,6 +46,9 @@ bool GPGManager::Initialize(bool ui_login) {
   return false;
 #else
   state_ = kStart;
+  logged_in_ = false;
+  toggle_sign_in_requested_ = false;
+  auth_mailbox_.Clear();
   do_ui_login_ = ui_login;
   event_data_initialized_ = false;
   achievement_data_initialized_ = false;
@@ -67,32 +72,16 @@ bool GPGManager::Initialize(bool ui_login) {
       gpg::GameServices::Builder()
           .SetDefaultOnLog(gpg::LogLevel::VERBOSE)
           .SetOnAuthActionStarted([this](gpg::AuthOperation op) {
-             state_ =
-                 state_ == kAuthUILaunched ? kAuthUIStarted : kAutoAuthStarted;
-             LogInfo("GPG: Sign in started! (%d)", state_);
+             AuthEvent event = {true, op, gpg::AuthStatus::VALID};
+             if (!auth_mailbox_.Push(event)) {
+               LogError("GPG: auth mailbox full, dropping start event");
+             }
            })
           .SetOnAuthActionFinished([this](gpg::AuthOperation op,
                                           gpg::AuthStatus status) {
-             LogInfo("GPG: Sign in finished with a result of %d (%d)", status,
-                     state_);
-             if (op == gpg::AuthOperation::SIGN_IN) {
-               state_ = status == gpg::AuthStatus::VALID
-                            ? kAuthed
-                            : ((state_ == kAuthUIStarted ||
-                                state_ == kAuthUILaunched)
-                                   ? kAuthUIFailed
-                                   : kAutoAuthFailed);
-               if (state_ == kAuthed) {
-                 // If we just logged in, go fetch our data!
-                 FetchPlayer();
-                 FetchEvents();
-                 FetchAchievements();
-               }
-             } else if (op == gpg::AuthOperation::SIGN_OUT) {
-               state_ = kStart;
-               LogInfo("GPG: SIGN OUT finished with a result of %d", status);
-             } else {
-               LogInfo("GPG: unknown auth op %d", op);
+             AuthEvent event = {false, op, status};
+             if (!auth_mailbox_.Push(event)) {
+               LogError("GPG: auth mailbox full, dropping finish event");
              }
            })
           .Create(platform_configuration);
@@ -107,11 +96,66 @@ bool GPGManager::Initialize(bool ui_login) {
 #endif
 }
 
+#ifdef USING_GOOGLE_PLAY_GAMES
+void GPGManager::HandleAuthEvent(const AuthEvent &event) {
+  if (event.started) {
+    state_ = state_ == kAuthUILaunched ? kAuthUIStarted : kAutoAuthStarted;
+    LogInfo("GPG: Sign in started! (%d)", state_);
+    return;
+  }
+  LogInfo("GPG: Sign in finished with a result of %d (%d)", event.status,
+          state_);
+  if (event.op == gpg::AuthOperation::SIGN_IN) {
+    state_ = event.status == gpg::AuthStatus::VALID
+                 ? kAuthed
+                 : ((state_ == kAuthUIStarted || state_ == kAuthUILaunched)
+                        ? kAuthUIFailed
+                        : kAutoAuthFailed);
+    logged_in_.store(state_ == kAuthed, std::memory_order_release);
+    if (state_ == kAuthed) {
+      // If we just logged in, go fetch our data!
+      FetchPlayer();
+      FetchEvents();
+      FetchAchievements();
+    }
+  } else if (event.op == gpg::AuthOperation::SIGN_OUT) {
+    state_ = kStart;
+    logged_in_.store(false, std::memory_order_release);
+    LogInfo("GPG: SIGN OUT finished with a result of %d", event.status);
+  } else {
+    LogInfo("GPG: unknown auth op %d", event.op);
+  }
+}
+#endif
+
 // Called every frame from the game, to see if there's anything to be done
 // with the async progress from gpg
 void GPGManager::Update() {
 #ifdef USING_GOOGLE_PLAY_GAMES
   assert(game_services_);
+
+  // Pick up sign in/out requests from the UI.
+  if (toggle_sign_in_requested_.exchange(false, std::memory_order_acq_rel)) {
+    delayed_login_ = false;
+    if (state_ == kAuthed) {
+      LogInfo("GPG: Attempting to log out...");
+      game_services_->SignOut();
+    } else if (state_ == kStart || state_ == kAuthUIFailed) {
+      LogInfo("GPG: Attempting to log in...");
+      state_ = kManualSignBackIn;
+      do_ui_login_ = true;
+    } else {
+      LogInfo("GPG: Ignoring log in/out in state %d", state_);
+      delayed_login_ = true;
+    }
+  }
+
+  // Apply whatever GPG has told us since the last update.
+  AuthEvent event;
+  while (auth_mailbox_.Pop(&event)) {
+    HandleAuthEvent(event);
+  }
+
   switch (state_) {
     case kStart:
     case kAutoAuthStarted:
@@ -155,11 +199,7 @@ bool GPGManager::LoggedIn() {
 #ifndef USING_GOOGLE_PLAY_GAMES
   return false;
 #else
-  assert(game_services_);
-  if (state_ < kAuthed) {
-    return false;
-  }
-  return true;
+  return logged_in_.load(std::memory_order_acquire);
 #endif
 }
 
@@ -167,18 +207,7 @@ void GPGManager::ToggleSignIn() {
 #ifndef USING_GOOGLE_PLAY_GAMES
   return;
 #else
-  delayed_login_ = false;
-  if (state_ == kAuthed) {
-    LogInfo("GPG: Attempting to log out...");
-    game_services_->SignOut();
-  } else if (state_ == kStart || state_ == kAuthUIFailed) {
-    LogInfo("GPG: Attempting to log in...");
-    state_ = kManualSignBackIn;
-    do_ui_login_ = true;
-  } else {
-    LogInfo("GPG: Ignoring log in/out in state %d", state_);
-    delayed_login_ = true;
-  }
+  toggle_sign_in_requested_.store(true, std::memory_order_release);
 #endif
 }
 
@@ -253,20 +282,34 @@ void GPGManager::SubmitScore(std::string leaderboard_id, int64_t score) {
 #endif
 }
 
-// Submit score to specified leaderboard.
-int64_t GPGManager::CurrentPlayerHighScore(std::string leaderboard_id) {
+void GPGManager::FetchPlayerHighScore(std::string leaderboard_id,
+                                      const HighScoreCallback &callback) {
 #ifndef USING_GOOGLE_PLAY_GAMES
   (void)leaderboard_id;
-  return 0;
+  callback(false, 0);
 #else
-  if (!LoggedIn()) return 0;
-  auto response = game_services_->Leaderboards().FetchScoreSummaryBlocking(
+  if (!LoggedIn()) {
+    callback(false, 0);
+    return;
+  }
+  game_services_->Leaderboards().FetchScoreSummary(
       leaderboard_id, gpg::LeaderboardTimeSpan::ALL_TIME,
-      gpg::LeaderboardCollection::PUBLIC);
-  auto score = response.data.CurrentPlayerScore().Value();
-  LogInfo("GPG: player score %llu for leaderboard id %s", score,
-          leaderboard_id.c_str());
-  return score;
+      gpg::LeaderboardCollection::PUBLIC,
+      [leaderboard_id, callback](
+          const gpg::LeaderboardManager::FetchScoreSummaryResponse &response) {
+        if (!IsSuccess(response.status)) {
+          LogInfo("GPG: score fetch for leaderboard id %s failed (%d)",
+                  leaderboard_id.c_str(), response.status);
+          callback(false, 0);
+          return;
+        }
+        const gpg::Score &score = response.data.CurrentPlayerScore();
+        const int64_t value =
+            score.Valid() ? static_cast<int64_t>(score.Value()) : 0;
+        LogInfo("GPG: player score %lld for leaderboard id %s",
+                static_cast<long long>(value), leaderboard_id.c_str());
+        callback(true, value);
+      });
 #endif
 }
 
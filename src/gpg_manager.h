@@ -15,8 +15,12 @@
 #ifndef GPG_MANAGER_H
 #define GPG_MANAGER_H
 
+#include <atomic>
+#include <functional>
 #include <string>
 
+#include "spsc_queue.h"
+
 #ifdef USING_GOOGLE_PLAY_GAMES
 #include "gpg/gpg.h"
 #include "gpg/achievement_manager.h"
@@ -44,14 +48,16 @@ class GPGManager {
   // Start of initial initialization and auth.
   bool Initialize(bool ui_login);
 
-  // Call once a frame to allow us to track our async work.
+  // Call once a frame to allow us to track our async work. This applies the
+  // results GPG has posted since the last call, so it should be called from
+  // the update thread, never between submitting a frame and waiting for vsync.
   void Update();
 
   // To be called from UI to sign out (if we were signed in) or sign back in
-  // (if we were signed out).
+  // (if we were signed out). The request is picked up by the next Update().
   void ToggleSignIn();
 
-  // Logged in status, can be shown in UI.
+  // Logged in status, can be shown in UI. Safe to call from any thread.
   bool LoggedIn();
 
   struct GPGIds {
@@ -69,9 +75,15 @@ class GPGManager {
   // Submit score to specified leaderboard.
   void SubmitScore(std::string leaderboard_id, int64_t score);
 
-  // Retrieve current player's high score.
-  // Returns 0 if no player has been signed in.
-  int64_t CurrentPlayerHighScore(std::string leaderboard_id);
+  // Called with whether the fetch succeeded, and the player's score.
+  typedef std::function<void(bool success, int64_t score)>
+      HighScoreCallback;
+
+  // Asynchronously fetches the current player's all-time score on the given
+  // leaderboard. `callback` is called on GPG's callback thread, with a score
+  // of 0 if the player has none yet. Fails immediately if not logged in.
+  void FetchPlayerHighScore(std::string leaderboard_id,
+                            const HighScoreCallback &callback);
 
   // Asynchronously fetches the stats associated with the current player
   // from the server.  (Does nothing if not logged in.)
@@ -113,7 +125,24 @@ class GPGManager {
     kAuthed,
   };
 
+  // An auth callback from GPG, handed to Update() through auth_mailbox_.
+  struct AuthEvent {
+    bool started;
+    gpg::AuthOperation op;
+    gpg::AuthStatus status;
+  };
+
+  // Apply an auth callback to state_. Only called from Update().
+  void HandleAuthEvent(const AuthEvent &event);
+
+  // state_ is only touched by Update() and HandleAuthEvent(). Other threads
+  // see the result through logged_in_.
   AsyncState state_;
+  std::atomic<bool> logged_in_;
+  std::atomic<bool> toggle_sign_in_requested_;
+  // GPG delivers its callbacks on a single thread, which is the producer;
+  // Update() is the consumer.
+  zooshi::SpscQueue<AuthEvent, 16> auth_mailbox_;
   bool do_ui_login_;
   bool delayed_login_;
   std::unique_ptr<gpg::GameServices> game_services_;
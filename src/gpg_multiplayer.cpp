@@ -21,8 +21,7 @@
 namespace fpl {
 
 GPGMultiplayer::GPGMultiplayer()
-    : message_mutex_(PTHREAD_MUTEX_INITIALIZER),
-      instance_mutex_(PTHREAD_MUTEX_INITIALIZER),
+    : instance_mutex_(PTHREAD_MUTEX_INITIALIZER),
       state_mutex_(PTHREAD_MUTEX_INITIALIZER) {}
 
 bool GPGMultiplayer::Initialize(const std::string& service_id) {
@@ -95,9 +94,9 @@ void GPGMultiplayer::ResetToIdle() {
   discovered_instances_.clear();
   pthread_mutex_unlock(&instance_mutex_);
 
-  pthread_mutex_lock(&message_mutex_);
-  while (!incoming_messages_.empty()) incoming_messages_.pop();
-  pthread_mutex_unlock(&message_mutex_);
+  // Everyone has been disconnected, so the next session can reuse every
+  // sender handle.
+  incoming_messages_.ClearInstanceIds();
 }
 
 void GPGMultiplayer::DisconnectInstance(const std::string& instance_id) {
@@ -145,8 +144,6 @@ void GPGMultiplayer::SendConnectionRequest(
     message_listener_.reset(new MessageListener(
         [this](const std::string& instance_id,
                std::vector<uint8_t> const& payload, bool is_reliable) {
-          LogInfo("GPGMultiplayer: OnMessageReceived(%s) callback",
-                       instance_id.c_str());
           this->MessageReceivedCallback(instance_id, payload, is_reliable);
         },
         [this](const std::string& instance_id) {
@@ -174,8 +171,6 @@ void GPGMultiplayer::AcceptConnectionRequest(
     message_listener_.reset(new MessageListener(
         [this](const std::string& instance_id,
                std::vector<uint8_t> const& payload, bool is_reliable) {
-          LogInfo("GPGMultiplayer: OnMessageReceived(%s) callback",
-                  instance_id.c_str());
           this->MessageReceivedCallback(instance_id, payload, is_reliable);
         },
         [this](const std::string& instance_id) {
@@ -522,20 +517,18 @@ void GPGMultiplayer::BroadcastMessage(const std::vector<uint8_t>& payload,
   }
 }
 
-bool GPGMultiplayer::HasMessage() {
-  pthread_mutex_lock(&message_mutex_);
-  bool empty = incoming_messages_.empty();
-  pthread_mutex_unlock(&message_mutex_);
-  return !empty;
+bool GPGMultiplayer::HasMessage() { return !incoming_messages_.empty(); }
+
+bool GPGMultiplayer::NextMessage(Message* message) {
+  return incoming_messages_.Pop(message);
 }
 
 GPGMultiplayer::SenderAndMessage GPGMultiplayer::GetNextMessage() {
-  if (HasMessage()) {
-    pthread_mutex_lock(&message_mutex_);
-    auto message = incoming_messages_.front();
-    incoming_messages_.pop();
-    pthread_mutex_unlock(&message_mutex_);
-    return message;
+  Message message;
+  if (NextMessage(&message)) {
+    return SenderAndMessage(
+        GetSenderInstanceId(message),
+        std::vector<uint8_t>(message.payload, message.payload + message.size));
   } else {
     SenderAndMessage blank{"", {}};
     return blank;
@@ -644,9 +637,15 @@ void GPGMultiplayer::ConnectionResponseCallback(
 void GPGMultiplayer::MessageReceivedCallback(
     const std::string& instance_id, std::vector<uint8_t> const& payload,
     bool is_reliable) {
-  pthread_mutex_lock(&message_mutex_);
-  incoming_messages_.push({instance_id, payload});
-  pthread_mutex_unlock(&message_mutex_);
+  // Connected instances are interned when they connect, so this is normally
+  // just a lookup.
+  const MultiplayerMessageQueue::InstanceHandle sender =
+      incoming_messages_.InternInstanceId(instance_id);
+  if (sender == MultiplayerMessageQueue::kInvalidInstance ||
+      !incoming_messages_.Push(sender, payload.data(), payload.size(),
+                               is_reliable)) {
+    LogError("GPGMultiplayer: Dropped message from %s", instance_id.c_str());
+  }
 }
 
 // Callback on host or client when a connected instance disconnects.
@@ -697,6 +696,9 @@ void GPGMultiplayer::UpdateConnectedInstances() {
 
 // Important: make sure you lock instance_mutex_ before calling this.
 int GPGMultiplayer::AddNewConnectedInstance(const std::string& instance_id) {
+  // Intern the instance up front, so that receiving its messages never has
+  // to.
+  incoming_messages_.InternInstanceId(instance_id);
   int new_index = -1;
   // First, check if we are a reconnection.
   if (state() == kConnectedWithDisconnections) {
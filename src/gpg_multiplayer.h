@@ -58,12 +58,16 @@
 #include <string>
 #include <vector>
 
+#include "multiplayer_message_queue.h"
+
 namespace fpl {
 
 class GPGMultiplayer {
  public:
   // In the pair, first = the sender's instance_id, second = the message.
   typedef std::pair<std::string, std::vector<uint8_t>> SenderAndMessage;
+  // A received message whose payload is still in the receive queue.
+  typedef MultiplayerMessageQueue::Message Message;
 
   enum MultiplayerState {
     // Starting state, you aren't connected, broadcasting, or scanning.
@@ -108,7 +112,8 @@ class GPGMultiplayer {
   // if a user scanning for games doesn't have this one installed.
   void AddAppIdentifier(const std::string& identifier);
 
-  // Update, call this once per frame if you can.
+  // Update, call this once per frame if you can. Call it from the update
+  // thread, not the render thread, as it may need to take several locks.
   void Update();
 
   // Broadcast that you are hosting a game. To change the name from the default,
@@ -189,8 +194,19 @@ class GPGMultiplayer {
   // You would then call GetNextMessage() to retrieve the next message.
   bool HasMessage();
 
+  // Get the next incoming message, releasing the one fetched by the previous
+  // call. The payload points into the receive queue and is only valid until
+  // the next call. Returns false if there are no messages. This neither locks
+  // nor allocates, so prefer it to GetNextMessage().
+  bool NextMessage(Message* message);
+
+  // The instance ID of the player that sent `message`.
+  const std::string& GetSenderInstanceId(const Message& message) const {
+    return incoming_messages_.instance_id(message.sender);
+  }
+
   // Get the latest incoming message, or a blank sender and message if there are
-  // none.
+  // none. This copies the sender and message; see NextMessage().
   SenderAndMessage GetNextMessage();
 
   // Returns true if a player has just reconnected.
@@ -227,8 +243,6 @@ class GPGMultiplayer {
   bool allow_reconnecting() const { return allow_reconnecting_; }
 
  private:
-  typedef std::queue<SenderAndMessage> MessageQueue;
-
   // Listens for hosts that are advertising.
   class DiscoveryListener : public gpg::IEndpointDiscoveryListener {
    public:
@@ -256,8 +270,8 @@ class GPGMultiplayer {
   class MessageListener : public gpg::IMessageListener {
    public:
     explicit MessageListener(
-        std::function<void(const std::string&, std::vector<uint8_t>, bool)>
-            message_received_callback,
+        std::function<void(const std::string&, const std::vector<uint8_t>&,
+                           bool)> message_received_callback,
         std::function<void(const std::string&)> disconnected_callback)
         : message_received_callback_(message_received_callback),
           disconnected_callback_(disconnected_callback) {}
@@ -275,7 +289,7 @@ class GPGMultiplayer {
     }
 
    private:
-    std::function<void(const std::string&, std::vector<uint8_t>, bool)>
+    std::function<void(const std::string&, const std::vector<uint8_t>&, bool)>
         message_received_callback_;
     std::function<void(const std::string&)> disconnected_callback_;
   };
@@ -359,8 +373,9 @@ class GPGMultiplayer {
   // so the user code can send them a game state update.
   std::queue<int> reconnected_players_;
 
-  // List of incoming messages. Lock message_mutex_ before using.
-  MessageQueue incoming_messages_;
+  // Incoming messages. Filled by the NearbyConnections callback thread and
+  // drained by the game, without locking.
+  MultiplayerMessageQueue incoming_messages_;
 
   // Our current state.
   MultiplayerState state_;
@@ -370,9 +385,6 @@ class GPGMultiplayer {
   std::string my_instance_name_;
   int max_connected_players_allowed_;  // 0 to allow any number
 
-  // Mutex for the incoming_messages_ queue.
-  pthread_mutex_t message_mutex_;
-
   // Mutex for instance management: connected_instances_, pending_instances_,
   // discovered_instances, and instance_names_.
   pthread_mutex_t instance_mutex_;
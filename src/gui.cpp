@@ -17,7 +17,6 @@
 #include "mathfu/internal/disable_warnings_begin.h"
 
 #include "firebase/analytics.h"
-#include "firebase/remote_config.h"
 
 #include "mathfu/internal/disable_warnings_end.h"
 
@@ -138,9 +137,8 @@ MenuState GameMenuState::StartMenu(fplbase::AssetManager& assetman,
                        mathfu::vec2(0, -150));
     flatui::SetMargin(flatui::Margin(200, 700, 200, 100));
 
-    auto event = TextButton(
-        firebase::remote_config::GetString(kConfigMenuPlayGame).c_str(),
-        kMenuSize, flatui::Margin(0), sound_start_);
+    auto event = TextButton(world_->remote_config->menu_play_game().c_str(),
+                            kMenuSize, flatui::Margin(0), sound_start_);
     if (event & flatui::kEventWentUp) {
       next_state = kMenuStateFinished;
 #ifdef ANDROID_GAMEPAD
@@ -171,11 +169,11 @@ MenuState GameMenuState::StartMenu(fplbase::AssetManager& assetman,
     // Since sending invites and admob video are currently not supported on
     // desktop, and the UI space is limited, only offer the option on Android.
 #ifdef __ANDROID__
-    event = TextButton(
-        firebase::remote_config::GetString(kConfigMenuSendInvite).c_str(),
-        kMenuSize, flatui::Margin(0));
+    event = TextButton(world_->remote_config->menu_send_invite().c_str(),
+                       kMenuSize, flatui::Margin(0));
     if (event & flatui::kEventWentUp) {
-      firebase::analytics::LogEvent(kEventMenuSendInvite);
+      world_->analytics.LogUiEvent(
+          AnalyticsEvent(kAnalyticsEventMenuSendInvite));
       SendInvite();
       next_state = kMenuStateSendingInvite;
     }
@@ -183,9 +181,8 @@ MenuState GameMenuState::StartMenu(fplbase::AssetManager& assetman,
         !world_->admob_helper->rewarded_video_watched() &&
         world_->admob_helper->GetRewardedVideoLocation() ==
             kRewardedVideoLocationPregame) {
-      event = TextButton(
-          firebase::remote_config::GetString(kConfigMenuOfferVideo).c_str(),
-          kMenuSize, flatui::Margin(0));
+      event = TextButton(world_->remote_config->menu_offer_video().c_str(),
+                         kMenuSize, flatui::Margin(0));
       if (event & flatui::kEventWentUp) {
         StartRewardedVideo();
       }
@@ -193,7 +190,7 @@ MenuState GameMenuState::StartMenu(fplbase::AssetManager& assetman,
 #endif  // __ANDROID__
     event = TextButton("Options", kMenuSize, flatui::Margin(0));
     if (event & flatui::kEventWentUp) {
-      firebase::analytics::LogEvent(kEventMenuOptions);
+      world_->analytics.LogUiEvent(AnalyticsEvent(kAnalyticsEventMenuOptions));
       next_state = kMenuStateOptions;
       options_menu_state_ = kOptionsMenuStateMain;
     }
@@ -221,7 +218,7 @@ MenuState GameMenuState::StartMenu(fplbase::AssetManager& assetman,
         ImageButtonWithLabel(*button_back_, 60, flatui::Margin(60, 35, 40, 50),
                              current_sushi->name()->c_str());
     if (event & flatui::kEventWentUp) {
-      firebase::analytics::LogEvent(kEventMenuSushi);
+      world_->analytics.LogUiEvent(AnalyticsEvent(kAnalyticsEventMenuSushi));
       next_state = kMenuStateOptions;
       options_menu_state_ = kOptionsMenuStateSushi;
     }
@@ -229,7 +226,7 @@ MenuState GameMenuState::StartMenu(fplbase::AssetManager& assetman,
         ImageButtonWithLabel(*button_back_, 60, flatui::Margin(60, 35, 40, 50),
                              world_->CurrentLevel()->name()->c_str());
     if (event & flatui::kEventWentUp) {
-      firebase::analytics::LogEvent(kEventMenuLevel);
+      world_->analytics.LogUiEvent(AnalyticsEvent(kAnalyticsEventMenuLevel));
       next_state = kMenuStateOptions;
       options_menu_state_ = kOptionsMenuStateLevel;
     }
@@ -425,9 +422,9 @@ void GameMenuState::OptionMenuAbout() {
   flatui::SetMargin(flatui::Margin(50, 0, 0, 0));
   flatui::StartGroup(flatui::kLayoutVerticalCenter, 0, "scroll");
   flatui::StartScroll(kScrollAreaSize, &scroll_offset_);
-  flatui::Label(about_text_.c_str(), 35, vec2(kScrollAreaSize.x, 0),
-                flatui::kTextAlignmentLeftJustify);
-  vec2 scroll_size = flatui::GroupSize();
+  vec2 scroll_size = about_text_.Label(
+      35, kScrollAreaSize.x, flatui::kTextAlignmentLeftJustify, false,
+      scroll_offset_, kScrollAreaSize.y);
   flatui::EndScroll();
   flatui::EndGroup();
 
@@ -469,12 +466,9 @@ void GameMenuState::OptionMenuLicenses() {
   if (!flatui::IsLastEventPointerType())
     flatui::EventBackground(event);
 
-  flatui::EnableTextHyphenation(true);
-  flatui::Label(license_text_.c_str(), 25, vec2(kScrollAreaSize.x, 0),
-                flatui::kTextAlignmentLeftJustify);
-  flatui::EnableTextHyphenation(false);
-
-  vec2 scroll_size = flatui::GroupSize();
+  vec2 scroll_size = license_text_.Label(
+      25, kScrollAreaSize.x, flatui::kTextAlignmentLeftJustify, true,
+      scroll_offset_, kScrollAreaSize.y);
   flatui::EndScroll();
   flatui::EndGroup();
 
@@ -35,6 +35,16 @@ void AndroidCardboardController::UpdateOrientation() {
   facing_.Update();
   up_.Update();
 
+  vec3 forward;
+  vec3 up;
+  if (LatestOrientation(&forward, &up)) {
+    facing_.SetValue(forward);
+    up_.SetValue(up);
+  }
+}
+
+bool AndroidCardboardController::LatestOrientation(vec3* facing,
+                                                   vec3* up) const {
 #if FPLBASE_ANDROID_VR
   // Cardboard uses a different coordinate space than we use, so we have to
   // remap the axes and swap the handedness before we can use the
@@ -42,11 +52,14 @@ void AndroidCardboardController::UpdateOrientation() {
   const fplbase::HeadMountedDisplayInput& head_mounted_display_input =
     input_system_->head_mounted_display_input();
   const vec3 hmd_forward = head_mounted_display_input.forward();
-  const vec3 forward = vec3(hmd_forward.x, -hmd_forward.z, hmd_forward.y);
+  *facing = vec3(hmd_forward.x, -hmd_forward.z, hmd_forward.y);
   const vec3 hmd_up = head_mounted_display_input.up();
-  const vec3 up = vec3(hmd_up.x, -hmd_up.z, hmd_up.y);
-  facing_.SetValue(forward);
-  up_.SetValue(up);
+  *up = vec3(hmd_up.x, -hmd_up.z, hmd_up.y);
+  return true;
+#else
+  (void)facing;
+  (void)up;
+  return false;
 #endif  // FPLBASE_ANDROID_VR
 }
 
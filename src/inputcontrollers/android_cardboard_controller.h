@@ -28,6 +28,7 @@ class AndroidCardboardController : public BasePlayerController {
   virtual ~AndroidCardboardController() {}
 
   virtual void Update();
+  virtual bool LatestOrientation(mathfu::vec3* facing, mathfu::vec3* up) const;
 
  private:
   void UpdateOrientation();
@@ -72,6 +72,23 @@ class BasePlayerController {
 
   virtual void Update() = 0;
 
+  // Sample the newest orientation straight from the input system, without
+  // changing the controller's state. The render thread uses this to
+  // late-latch the camera after pumping input. Returns false if the
+  // controller has nothing newer than facing() and up().
+  virtual bool LatestOrientation(mathfu::vec3* /*facing*/,
+                                 mathfu::vec3* /*up*/) const {
+    return false;
+  }
+
+  // True if the controller fires on every left mouse button or finger press.
+  // The player then takes presses from the timestamped input event queue,
+  // instead of polling Button(kFireProjectile) once per update.
+  virtual bool FiresOnPointerPress() const { return false; }
+
+  // True if the screen position of a press aims the projectile.
+  virtual bool AimsWithPointer() const { return false; }
+
   void ResetFacing() {
     facing_.SetValue(kCameraForward);
     up_.SetValue(kCameraUp);
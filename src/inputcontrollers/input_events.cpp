@@ -0,0 +1,46 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "inputcontrollers/input_events.h"
+
+#include "fplbase/input.h"
+
+namespace fpl {
+namespace zooshi {
+
+// Milliseconds on the input system's clock. Wraps after about 49 days, which
+// the age computations in the player component tolerate.
+static uint32_t Milliseconds(double seconds) {
+  return static_cast<uint32_t>(static_cast<uint64_t>(seconds * 1000.0));
+}
+
+uint32_t InputEventTicks(const fplbase::InputSystem& input) {
+  return Milliseconds(input.RealTime());
+}
+
+void RecordPointerPresses(fplbase::InputSystem* input,
+                          InputEventQueue* queue) {
+  const std::vector<fplbase::InputPointer>& pointers = input->get_pointers();
+  InputEvent input_event;
+  // Every press seen in one input frame was polled at the same time.
+  input_event.timestamp = Milliseconds(input->Time());
+  for (size_t i = 0; i < pointers.size(); ++i) {
+    if (!input->GetPointerButton(i).went_down()) continue;
+    input_event.position = pointers[i].mousepos;
+    queue->Push(input_event);
+  }
+}
+
+}  // zooshi
+}  // fpl
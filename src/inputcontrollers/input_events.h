@@ -0,0 +1,56 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_INPUT_EVENTS_H
+#define ZOOSHI_INPUT_EVENTS_H
+
+#include <stdint.h>
+
+#include "mathfu/glsl_mappings.h"
+#include "spsc_queue.h"
+
+namespace fplbase {
+class InputSystem;
+}  // fplbase
+
+namespace fpl {
+namespace zooshi {
+
+// A pointer press (mouse button or finger), stamped with the time the input
+// system polled it.
+struct InputEvent {
+  // Milliseconds, on the same clock as InputEventTicks().
+  uint32_t timestamp;
+  // Screen space, with 0,0 as top-left.
+  mathfu::vec2i position;
+};
+
+// Filled by RecordPointerPresses() on the render thread, which owns the input
+// system, and drained by the player component on the update thread. Presses
+// that arrive while the queue is full are dropped.
+typedef SpscQueue<InputEvent, 64> InputEventQueue;
+
+// The current time on the clock used by InputEvent::timestamp.
+uint32_t InputEventTicks(const fplbase::InputSystem& input);
+
+// Records every pointer that went down during the input system's last
+// AdvanceFrame() in `queue`, at the pointer's position. Call after every
+// AdvanceFrame(). A press that goes down and up within one input frame still
+// reports went_down(), so short taps are not lost.
+void RecordPointerPresses(fplbase::InputSystem* input, InputEventQueue* queue);
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_INPUT_EVENTS_H
@@ -29,15 +29,30 @@ void MouseController::Update() {
   UpdateButtons();
 }
 
+bool MouseController::LatestOrientation(vec3* facing, vec3* up) const {
+  // The update thread has not consumed this frame's mouse movement yet, so
+  // apply it on top of the last facing it produced.
+  *facing = ApplyMouseDelta(facing_.Value());
+  *up = kCameraUp;
+  return true;
+}
+
 void MouseController::UpdateFacing() {
   facing_.Update();
   up_.Update();
 
   up_.SetValue(kCameraUp);
-  vec2 delta = vec2(input_system_->get_pointers()[0].mousedelta);
+  const vec2i& mouse_delta = input_system_->get_pointers()[0].mousedelta;
 
   // If the mouse hasn't moved, return.
-  if (delta.x == 0 && delta.y == 0) return;
+  if (mouse_delta.x == 0 && mouse_delta.y == 0) return;
+
+  facing_.SetValue(ApplyMouseDelta(facing_.Value()));
+}
+
+vec3 MouseController::ApplyMouseDelta(const vec3& facing) const {
+  vec2 delta = vec2(input_system_->get_pointers()[0].mousedelta);
+  if (delta.x == 0 && delta.y == 0) return facing;
 
   delta *= input_config_->mouse_sensitivity();
 
@@ -50,7 +65,7 @@ void MouseController::UpdateFacing() {
 
   // We assume that the player is looking along the x axis, before
   // camera transformations are applied:
-  vec3 facing_vector = facing_.Value();
+  vec3 facing_vector = facing;
   vec3 side_vector =
       quat::FromAngleAxis(-static_cast<float>(M_PI_2), mathfu::kAxisZ3f) *
       facing_vector;
@@ -58,9 +73,7 @@ void MouseController::UpdateFacing() {
   quat pitch_adjustment = quat::FromAngleAxis(delta.y, side_vector);
   quat yaw_adjustment = quat::FromAngleAxis(delta.x, mathfu::kAxisZ3f);
 
-  facing_vector = pitch_adjustment * yaw_adjustment * facing_vector;
-
-  facing_.SetValue(facing_vector);
+  return pitch_adjustment * yaw_adjustment * facing_vector;
 }
 
 void MouseController::UpdateButtons() {
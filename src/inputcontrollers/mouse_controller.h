@@ -26,9 +26,13 @@ class MouseController : public BasePlayerController {
   virtual ~MouseController() {}
 
   virtual void Update();
+  virtual bool LatestOrientation(mathfu::vec3* facing, mathfu::vec3* up) const;
+  virtual bool FiresOnPointerPress() const { return true; }
   MATHFU_DEFINE_CLASS_SIMD_AWARE_NEW_DELETE
 
  private:
+  // Returns `facing` rotated by the mouse movement of the current frame.
+  mathfu::vec3 ApplyMouseDelta(const mathfu::vec3& facing) const;
   void UpdateFacing();
   void UpdateButtons();
 };
@@ -34,6 +34,9 @@ class OnscreenController : public GamepadController {
 
   virtual ~OnscreenController() {}
 
+  virtual bool FiresOnPointerPress() const { return true; }
+  virtual bool AimsWithPointer() const { return true; }
+
  protected:
   // Calculate the camera delta from onscreen button pushes.
   virtual mathfu::vec2 GetDelta() const { return delta_; }
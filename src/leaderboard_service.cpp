@@ -0,0 +1,200 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "leaderboard_service.h"
+
+#include "SDL_timer.h"
+#include "fplbase/utilities.h"
+
+namespace fpl {
+namespace zooshi {
+
+std::string LeaderboardId(const GPGConfig* gpg_config, const char* name) {
+  if (gpg_config == nullptr || gpg_config->leaderboards() == nullptr) {
+    return std::string();
+  }
+  const GPGLeaderboard* leaderboard =
+      gpg_config->leaderboards()->LookupByKey(name);
+  return leaderboard != nullptr && leaderboard->id() != nullptr
+             ? leaderboard->id()->str()
+             : std::string();
+}
+
+bool GPGLeaderboardBackend::Available() { return gpg_manager_->LoggedIn(); }
+
+void GPGLeaderboardBackend::FetchPlayerScore(const std::string& leaderboard_id,
+                                             const FetchCallback& callback) {
+  gpg_manager_->FetchPlayerHighScore(leaderboard_id, callback);
+}
+
+void GPGLeaderboardBackend::SubmitScore(const std::string& leaderboard_id,
+                                        int64_t score) {
+  gpg_manager_->SubmitScore(leaderboard_id, score);
+}
+
+FakeLeaderboardBackend::FakeLeaderboardBackend(const FakeLeaderboardDef* def)
+    : latency_(def->latency()),
+      fail_fetches_(def->fail_fetches()),
+      initial_score_(def->initial_score()) {}
+
+void FakeLeaderboardBackend::FetchPlayerScore(
+    const std::string& leaderboard_id, const FetchCallback& callback) {
+  PendingFetch fetch;
+  fetch.leaderboard_id = leaderboard_id;
+  fetch.callback = callback;
+  fetch.due_time = SDL_GetTicks() + latency_;
+  pending_.push_back(fetch);
+}
+
+void FakeLeaderboardBackend::SubmitScore(const std::string& leaderboard_id,
+                                         int64_t score) {
+  // Like Play Games, only keep the best.
+  if (score > Score(leaderboard_id)) scores_[leaderboard_id] = score;
+  fplbase::LogInfo("Fake leaderboard: submitted %lld for %s",
+                   static_cast<long long>(score), leaderboard_id.c_str());
+}
+
+void FakeLeaderboardBackend::Update() {
+  const uint32_t now = SDL_GetTicks();
+  // Callbacks may start new fetches, so answer from a copy.
+  std::vector<PendingFetch> due;
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    if (static_cast<int32_t>(now - it->due_time) >= 0) {
+      due.push_back(*it);
+      it = pending_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = due.begin(); it != due.end(); ++it) {
+    if (fail_fetches_) {
+      it->callback(false, 0);
+    } else {
+      it->callback(true, Score(it->leaderboard_id));
+    }
+  }
+}
+
+int64_t FakeLeaderboardBackend::Score(
+    const std::string& leaderboard_id) const {
+  auto it = scores_.find(leaderboard_id);
+  return it != scores_.end() ? it->second : initial_score_;
+}
+
+void LeaderboardService::Initialize(LeaderboardBackend* backend,
+                                    SaveManager* save_manager) {
+  backend_ = backend;
+  save_manager_ = save_manager;
+  fetching_.clear();
+  results_.Clear();
+  was_available_ = false;
+}
+
+void LeaderboardService::Prefetch(const std::string& leaderboard_id) {
+  // Remember the leaderboard even if it can't be fetched yet, so Update()
+  // fetches it once the backend is available.
+  fetching_.insert(std::make_pair(leaderboard_id, false));
+  StartFetch(leaderboard_id);
+}
+
+void LeaderboardService::Update() {
+  if (backend_ == nullptr) return;
+  backend_->Update();
+
+  FetchResult result;
+  while (results_.Pop(&result)) {
+    Reconcile(result);
+  }
+
+  // Catch up on every leaderboard when the player signs in.
+  const bool available = backend_->Available();
+  if (available && !was_available_) {
+    for (auto it = fetching_.begin(); it != fetching_.end(); ++it) {
+      StartFetch(it->first);
+    }
+  }
+  was_available_ = available;
+}
+
+int64_t LeaderboardService::BestScore(
+    const std::string& leaderboard_id) const {
+  return save_manager_->high_score(leaderboard_id).score;
+}
+
+bool LeaderboardService::ReportScore(const std::string& leaderboard_id,
+                                     int64_t score) {
+  SaveHighScore best = save_manager_->high_score(leaderboard_id);
+  const bool new_best = score > best.score;
+  if (new_best) {
+    best.score = score;
+    best.unconfirmed = true;
+    save_manager_->set_high_score(leaderboard_id, best);
+  }
+  if (backend_ != nullptr && backend_->Available()) {
+    backend_->SubmitScore(leaderboard_id, score);
+  }
+  return new_best;
+}
+
+void LeaderboardService::StartFetch(const std::string& leaderboard_id) {
+  if (backend_ == nullptr || !backend_->Available()) return;
+  bool& fetching = fetching_[leaderboard_id];
+  if (fetching) return;
+  fetching = true;
+
+  SpscQueue<FetchResult, 16>* results = &results_;
+  backend_->FetchPlayerScore(
+      leaderboard_id, [results, leaderboard_id](bool success, int64_t score) {
+        FetchResult result;
+        result.leaderboard_id = leaderboard_id;
+        result.success = success;
+        result.score = score;
+        if (!results->Push(result)) {
+          fplbase::LogError("Leaderboard: result queue full, dropping %s",
+                            leaderboard_id.c_str());
+        }
+      });
+}
+
+void LeaderboardService::Reconcile(const FetchResult& result) {
+  fetching_[result.leaderboard_id] = false;
+  if (!result.success) {
+    fplbase::LogInfo("Leaderboard: no server score for %s, keeping %lld",
+                     result.leaderboard_id.c_str(),
+                     static_cast<long long>(BestScore(result.leaderboard_id)));
+    return;
+  }
+
+  SaveHighScore best = save_manager_->high_score(result.leaderboard_id);
+  if (result.score > best.score) {
+    // Set on another device, or before the save file existed.
+    best.score = result.score;
+    best.unconfirmed = false;
+  } else if (result.score < best.score) {
+    // The submission never arrived, e.g. the game ended offline.
+    if (backend_->Available()) {
+      fplbase::LogInfo("Leaderboard: resubmitting %lld for %s",
+                       static_cast<long long>(best.score),
+                       result.leaderboard_id.c_str());
+      backend_->SubmitScore(result.leaderboard_id, best.score);
+    }
+    best.unconfirmed = true;
+  } else {
+    best.unconfirmed = false;
+  }
+  save_manager_->set_high_score(result.leaderboard_id, best);
+}
+
+}  // zooshi
+}  // fpl
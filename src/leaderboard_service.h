@@ -0,0 +1,161 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_LEADERBOARD_SERVICE_H_
+#define ZOOSHI_LEADERBOARD_SERVICE_H_
+
+#include <stdint.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gpg_generated.h"
+#include "gpg_manager.h"
+#include "save_manager.h"
+#include "spsc_queue.h"
+
+namespace fpl {
+namespace zooshi {
+
+// The id of the leaderboard called `name` in `gpg_config`, or an empty string
+// if there is none.
+std::string LeaderboardId(const GPGConfig* gpg_config, const char* name);
+
+// Where LeaderboardService fetches and submits scores.
+class LeaderboardBackend {
+ public:
+  typedef GPGManager::HighScoreCallback FetchCallback;
+
+  virtual ~LeaderboardBackend() {}
+
+  // Whether requests can be made right now, e.g. the player is signed in.
+  virtual bool Available() = 0;
+
+  // Start fetching the player's all-time score. `callback` may be called on
+  // another thread, but always the same one.
+  virtual void FetchPlayerScore(const std::string& leaderboard_id,
+                                const FetchCallback& callback) = 0;
+
+  virtual void SubmitScore(const std::string& leaderboard_id,
+                           int64_t score) = 0;
+
+  // Called by LeaderboardService::Update() on the update thread.
+  virtual void Update() {}
+};
+
+// Play Games leaderboards.
+class GPGLeaderboardBackend : public LeaderboardBackend {
+ public:
+  explicit GPGLeaderboardBackend(GPGManager* gpg_manager)
+      : gpg_manager_(gpg_manager) {}
+
+  virtual bool Available();
+  virtual void FetchPlayerScore(const std::string& leaderboard_id,
+                                const FetchCallback& callback);
+  virtual void SubmitScore(const std::string& leaderboard_id, int64_t score);
+
+ private:
+  GPGManager* gpg_manager_;
+};
+
+// An in-memory leaderboard server, for testing without Play Games. Fetches
+// are answered from Update() once the configured latency has passed.
+class FakeLeaderboardBackend : public LeaderboardBackend {
+ public:
+  explicit FakeLeaderboardBackend(const FakeLeaderboardDef* def);
+
+  virtual bool Available() { return true; }
+  virtual void FetchPlayerScore(const std::string& leaderboard_id,
+                                const FetchCallback& callback);
+  virtual void SubmitScore(const std::string& leaderboard_id, int64_t score);
+  virtual void Update();
+
+ private:
+  struct PendingFetch {
+    std::string leaderboard_id;
+    FetchCallback callback;
+    // SDL_GetTicks() at which to answer.
+    uint32_t due_time;
+  };
+
+  int64_t Score(const std::string& leaderboard_id) const;
+
+  std::map<std::string, int64_t> scores_;
+  std::vector<PendingFetch> pending_;
+  uint32_t latency_;
+  bool fail_fetches_;
+  int64_t initial_score_;
+};
+
+// Keeps the player's best score for each leaderboard without ever waiting on
+// the network. The best score is kept in the save file and is what a finished
+// game is compared against; the server's copy is fetched in the background
+// and reconciled with it. A higher score on the server, e.g. from another
+// device, replaces the local one, and a local score the server has not seen
+// is submitted again.
+//
+// Must only be called from the update thread. Backend callbacks are handed
+// over through a queue and applied by Update().
+class LeaderboardService {
+ public:
+  LeaderboardService()
+      : backend_(nullptr), save_manager_(nullptr), was_available_(false) {}
+
+  // `backend` may be null, in which case only the local best is kept.
+  void Initialize(LeaderboardBackend* backend, SaveManager* save_manager);
+
+  // Start fetching the server's score for `leaderboard_id` if one is not
+  // already on its way. If the backend is unavailable, the fetch is made
+  // once it becomes available. Call at the start of a session, so the result
+  // is in before the game ends.
+  void Prefetch(const std::string& leaderboard_id);
+
+  // Apply fetch results and catch up once the backend becomes available.
+  // Call once per frame.
+  void Update();
+
+  // The best score known for `leaderboard_id`. Never blocks.
+  int64_t BestScore(const std::string& leaderboard_id) const;
+
+  // Record a finished game's score, and submit it if the backend is
+  // available. Returns true if it beats the previous best.
+  bool ReportScore(const std::string& leaderboard_id, int64_t score);
+
+ private:
+  struct FetchResult {
+    FetchResult() : success(false), score(0) {}
+
+    std::string leaderboard_id;
+    bool success;
+    int64_t score;
+  };
+
+  void StartFetch(const std::string& leaderboard_id);
+  void Reconcile(const FetchResult& result);
+
+  LeaderboardBackend* backend_;
+  SaveManager* save_manager_;
+  // Leaderboards that have been prefetched, and whether a fetch for each is
+  // in flight. There is at most one fetch per leaderboard, so the queue only
+  // needs to be as long as the number of leaderboards.
+  std::map<std::string, bool> fetching_;
+  SpscQueue<FetchResult, 16> results_;
+  bool was_available_;
+};
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_LEADERBOARD_SERVICE_H_
@@ -0,0 +1,379 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "level_streamer.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+#include "fplbase/flatbuffer_utils.h"
+#include "fplbase/utilities.h"
+#include "mathfu/glsl_mappings.h"
+#include "world.h"
+
+using mathfu::vec2;
+using mathfu::vec3;
+using mathfu::vec3_packed;
+
+namespace fpl {
+namespace zooshi {
+
+// Rail the raft follows when the level does not name one.
+static const char kDefaultStreamingRail[] = "player_path";
+
+// Number of rail samples taken per chunk when assigning entities to chunks.
+// Only the chunk matters, so a coarse sampling is enough.
+static const int kSamplesPerChunk = 8;
+
+// Finds the rail sample nearest to a point on the XY plane. The samples are
+// bucketed into a uniform grid, and the search visits rings of cells around
+// the point until no unvisited cell can hold anything closer.
+class RailSampleGrid {
+ public:
+  RailSampleGrid(const std::vector<vec3_packed>& samples, float cell_size)
+      : samples_(samples),
+        cell_size_(cell_size),
+        min_x_(std::numeric_limits<int>::max()),
+        min_y_(std::numeric_limits<int>::max()),
+        max_x_(std::numeric_limits<int>::min()),
+        max_y_(std::numeric_limits<int>::min()) {
+    for (size_t i = 0; i < samples.size(); ++i) {
+      const vec3 p(samples[i]);
+      const int x = Cell(p.x());
+      const int y = Cell(p.y());
+      cells_[Key(x, y)].push_back(static_cast<uint32_t>(i));
+      min_x_ = std::min(min_x_, x);
+      min_y_ = std::min(min_y_, y);
+      max_x_ = std::max(max_x_, x);
+      max_y_ = std::max(max_y_, y);
+    }
+  }
+
+  // Index of the sample closest to `position`.
+  size_t Closest(const vec3& position) const {
+    const vec2 p = position.xy();
+    const int x = Cell(p.x());
+    const int y = Cell(p.y());
+    const int last_ring =
+        std::max(std::max(x - min_x_, max_x_ - x),
+                 std::max(y - min_y_, max_y_ - y));
+    size_t best = 0;
+    float best_dist_sq = std::numeric_limits<float>::infinity();
+    for (int ring = 0; ring <= last_ring; ++ring) {
+      // Cells in this ring are at least `ring - 1` cells away from the point.
+      const float ring_dist = static_cast<float>(std::max(ring - 1, 0)) *
+                              cell_size_;
+      if (ring_dist * ring_dist > best_dist_sq) break;
+      for (int dx = -ring; dx <= ring; ++dx) {
+        VisitCell(x + dx, y - ring, p, &best, &best_dist_sq);
+        if (ring > 0) VisitCell(x + dx, y + ring, p, &best, &best_dist_sq);
+      }
+      for (int dy = -ring + 1; dy <= ring - 1; ++dy) {
+        VisitCell(x - ring, y + dy, p, &best, &best_dist_sq);
+        VisitCell(x + ring, y + dy, p, &best, &best_dist_sq);
+      }
+    }
+    return best;
+  }
+
+ private:
+  int Cell(float coordinate) const {
+    return static_cast<int>(std::floor(coordinate / cell_size_));
+  }
+
+  static uint64_t Key(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+           static_cast<uint32_t>(y);
+  }
+
+  void VisitCell(int x, int y, const vec2& p, size_t* best,
+                 float* best_dist_sq) const {
+    auto cell = cells_.find(Key(x, y));
+    if (cell == cells_.end()) return;
+    for (auto it = cell->second.begin(); it != cell->second.end(); ++it) {
+      const float dist_sq = (vec3(samples_[*it]).xy() - p).LengthSquared();
+      if (dist_sq < *best_dist_sq) {
+        *best_dist_sq = dist_sq;
+        *best = *it;
+      }
+    }
+  }
+
+  const std::vector<vec3_packed>& samples_;
+  float cell_size_;
+  int min_x_;
+  int min_y_;
+  int max_x_;
+  int max_y_;
+  std::unordered_map<uint64_t, std::vector<uint32_t>> cells_;
+};
+
+// Returns the entity's TransformDef, or nullptr if it has none.
+static const corgi::TransformDef* FindTransformDef(const EntityDef* def) {
+  if (def->component_list() == nullptr) return nullptr;
+  for (auto component = def->component_list()->begin();
+       component != def->component_list()->end(); ++component) {
+    if (component->data_type() == ComponentDataUnion_corgi_TransformDef) {
+      return static_cast<const corgi::TransformDef*>(component->data());
+    }
+  }
+  return nullptr;
+}
+
+// Link `entity` to its children, which are only created at this point, and
+// then do the same for every child.
+static void UpdateChildLinksRecursively(corgi::EntityRef& entity,
+                                        World* world) {
+  world->transform_component.UpdateChildLinks(entity);
+  corgi::component_library::TransformData* transform_data =
+      world->transform_component.GetComponentData(entity);
+  if (transform_data == nullptr) return;
+  for (auto iter = transform_data->children.begin();
+       iter != transform_data->children.end(); ++iter) {
+    UpdateChildLinksRecursively(iter->owner, world);
+  }
+}
+
+// Apply the per-component fixups to `entity` and all of its descendants.
+static void PostLoadFixupRecursively(corgi::EntityRef& entity, World* world) {
+  world->patron_component.EntityPostLoadFixup(entity);
+  world->rail_denizen_component.EntityPostLoadFixup(entity);
+  world->scenery_component.EntityPostLoadFixup(entity);
+  world->graph_component.EntityPostLoadFixup(entity);
+  corgi::component_library::TransformData* transform_data =
+      world->transform_component.GetComponentData(entity);
+  if (transform_data == nullptr) return;
+  for (auto iter = transform_data->children.begin();
+       iter != transform_data->children.end(); ++iter) {
+    PostLoadFixupRecursively(iter->owner, world);
+  }
+}
+
+void LevelStreamer::Clear() {
+  filenames_.clear();
+  files_.clear();
+  chunks_.clear();
+  rail_end_time_ = 0.0f;
+  raft_chunk_ = -1;
+  loaded_chunk_count_ = 0;
+  resident_entity_count_ = 0;
+}
+
+void LevelStreamer::Load(const LevelDef* level_def, World* world) {
+  Clear();
+  const auto streamed_files = level_def->streamed_entity_files();
+  const StreamingDef* streaming = level_def->streaming();
+  if (streamed_files == nullptr || streamed_files->size() == 0 ||
+      streaming == nullptr) {
+    return;
+  }
+
+  // Gather every definition first; the buffers must not move once pointers
+  // into them have been taken.
+  filenames_.resize(streamed_files->size());
+  files_.resize(streamed_files->size());
+  std::vector<StreamedDef> defs;
+  for (flatbuffers::uoffset_t i = 0; i < streamed_files->size(); ++i) {
+    const char* filename = streamed_files->Get(i)->c_str();
+    filenames_[i] = filename;
+    if (!fplbase::LoadFile(filename, &files_[i])) {
+      fplbase::LogError("Can't load streamed entity file %s", filename);
+      continue;
+    }
+    const EntityListDef* entity_list = GetEntityListDef(files_[i].c_str());
+    if (entity_list->entity_list() == nullptr) continue;
+    for (auto def = entity_list->entity_list()->begin();
+         def != entity_list->entity_list()->end(); ++def) {
+      defs.push_back(StreamedDef(*def, i));
+    }
+  }
+
+  const char* rail_name = streaming->rail_name() != nullptr
+                              ? streaming->rail_name()->c_str()
+                              : kDefaultStreamingRail;
+  const Rail* rail = world->rail_manager.GetRailFromComponents(
+      rail_name, &world->entity_manager);
+  chunk_time_ = streaming->chunk_time();
+  if (rail == nullptr || chunk_time_ <= 0.0f) {
+    // Nothing to lay the chunks out along, so keep everything resident.
+    fplbase::LogError("Can't stream along rail %s; loading %d entities now.",
+                      rail_name, static_cast<int>(defs.size()));
+    for (auto def = defs.begin(); def != defs.end(); ++def) {
+      CreateEntity(*def, world);
+    }
+    resident_entity_count_ = defs.size();
+    files_.clear();
+    return;
+  }
+  rail_end_time_ = rail->EndTime();
+  chunks_ahead_ = std::max(streaming->chunks_ahead(), 0);
+  chunks_behind_ = std::max(streaming->chunks_behind(), 0);
+  wraps_ = rail->wraps();
+  const int chunk_count = std::max(
+      static_cast<int>(std::ceil(rail_end_time_ / chunk_time_)), 1);
+  chunks_.resize(chunk_count);
+
+  // Sample the rail, and size the grid cells to a few samples each.
+  std::vector<vec3_packed> samples;
+  rail->Positions(chunk_time_ / kSamplesPerChunk, &samples);
+  float max_step = 0.0f;
+  for (size_t i = 1; i < samples.size(); ++i) {
+    max_step = std::max(
+        max_step, (vec3(samples[i]) - vec3(samples[i - 1])).xy().Length());
+  }
+  const RailSampleGrid grid(samples, std::max(2.0f * max_step, 1.0f));
+
+  for (auto def = defs.begin(); def != defs.end(); ++def) {
+    const corgi::TransformDef* transform_def = FindTransformDef(def->def);
+    if (transform_def == nullptr || transform_def->position() == nullptr) {
+      CreateEntity(*def, world);
+      resident_entity_count_++;
+      continue;
+    }
+    const size_t sample = grid.Closest(LoadVec3(transform_def->position()));
+    const int chunk = std::min(static_cast<int>(sample) / kSamplesPerChunk,
+                               chunk_count - 1);
+    chunks_[chunk].defs.push_back(*def);
+  }
+
+  fplbase::LogInfo(
+      "Streaming %d entities in %d chunks of %.0fms along %s, %d resident",
+      static_cast<int>(defs.size() - resident_entity_count_), chunk_count,
+      chunk_time_, rail_name, static_cast<int>(resident_entity_count_));
+  Update(world);
+}
+
+void LevelStreamer::Update(World* world) {
+  if (chunks_.empty()) return;
+  corgi::EntityRef raft = world->services_component.raft_entity();
+  const RailDenizenData* raft_rail =
+      raft ? world->rail_denizen_component.GetComponentData(raft) : nullptr;
+  if (raft_rail == nullptr) return;
+
+  const int chunk_count = static_cast<int>(chunks_.size());
+  const int raft_chunk = std::min(
+      std::max(static_cast<int>(raft_rail->lap_progress * rail_end_time_ /
+                                chunk_time_),
+               0),
+      chunk_count - 1);
+  if (raft_chunk == raft_chunk_) return;
+  raft_chunk_ = raft_chunk;
+
+  for (int i = 0; i < chunk_count; ++i) {
+    if (chunks_[i].loaded && !ChunkWanted(i, raft_chunk)) {
+      UnloadChunk(&chunks_[i], world);
+    }
+  }
+  for (int i = 0; i < chunk_count; ++i) {
+    if (!chunks_[i].loaded && ChunkWanted(i, raft_chunk)) {
+      LoadChunk(&chunks_[i], world);
+    }
+  }
+}
+
+void LevelStreamer::StopStreaming(World* world) {
+  if (chunks_.empty()) return;
+  size_t created = 0;
+  for (auto chunk = chunks_.begin(); chunk != chunks_.end(); ++chunk) {
+    if (!chunk->loaded) {
+      LoadChunk(&*chunk, world);
+      created += chunk->entities.size();
+    }
+  }
+  // Every entity is resident from here on, so the chunks and the files they
+  // were created from are no longer needed.
+  resident_entity_count_ = LoadedEntityCount();
+  chunks_.clear();
+  files_.clear();
+  loaded_chunk_count_ = 0;
+  raft_chunk_ = -1;
+  fplbase::LogInfo("Stopped streaming; created %d entities",
+                   static_cast<int>(created));
+}
+
+bool LevelStreamer::ChunkWanted(int chunk, int raft_chunk) const {
+  int ahead = chunk - raft_chunk;
+  int behind = raft_chunk - chunk;
+  if (wraps_) {
+    const int chunk_count = static_cast<int>(chunks_.size());
+    ahead = (ahead + chunk_count) % chunk_count;
+    behind = (behind + chunk_count) % chunk_count;
+  }
+  return (0 <= ahead && ahead <= chunks_ahead_) ||
+         (0 <= behind && behind <= chunks_behind_);
+}
+
+void LevelStreamer::LoadChunk(Chunk* chunk, World* world) {
+  assert(!chunk->loaded);
+  chunk->entities.reserve(chunk->defs.size());
+  for (auto def = chunk->defs.begin(); def != chunk->defs.end(); ++def) {
+    chunk->entities.push_back(CreateEntity(*def, world));
+  }
+  chunk->loaded = true;
+  loaded_chunk_count_++;
+}
+
+void LevelStreamer::UnloadChunk(Chunk* chunk, World* world) {
+  assert(chunk->loaded);
+  // Deleting an entity also deletes its children.
+  for (auto it = chunk->entities.begin(); it != chunk->entities.end(); ++it) {
+    if (it->IsValid()) world->entity_manager.DeleteEntity(*it);
+  }
+  chunk->entities.clear();
+  chunk->loaded = false;
+  loaded_chunk_count_--;
+}
+
+corgi::EntityRef LevelStreamer::CreateEntity(const StreamedDef& def,
+                                             World* world) {
+  corgi::EntityRef entity = world->entity_factory->CreateEntityFromData(
+      def.def, &world->entity_manager);
+  if (!entity) return entity;
+  // Scene Lab saves each entity back to the file named here.
+  corgi::component_library::MetaData* meta_data =
+      world->meta_component.GetComponentData(entity);
+  if (meta_data != nullptr) meta_data->source_file = filenames_[def.file];
+  UpdateChildLinksRecursively(entity, world);
+  PostLoadFixupRecursively(entity, world);
+  return entity;
+}
+
+size_t LevelStreamer::LoadedEntityCount() const {
+  size_t count = resident_entity_count_;
+  for (auto chunk = chunks_.begin(); chunk != chunks_.end(); ++chunk) {
+    count += chunk->entities.size();
+  }
+  return count;
+}
+
+size_t LevelStreamer::MemoryBytes() const {
+  size_t bytes = (filenames_.capacity() + files_.capacity()) *
+                     sizeof(std::string) +
+                 chunks_.capacity() * sizeof(Chunk);
+  for (auto file = files_.begin(); file != files_.end(); ++file) {
+    bytes += file->capacity();
+  }
+  for (auto chunk = chunks_.begin(); chunk != chunks_.end(); ++chunk) {
+    bytes += chunk->defs.capacity() * sizeof(StreamedDef) +
+             chunk->entities.capacity() * sizeof(corgi::EntityRef);
+  }
+  return bytes;
+}
+
+}  // zooshi
+}  // fpl
@@ -0,0 +1,134 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_LEVEL_STREAMER_H_
+#define ZOOSHI_LEVEL_STREAMER_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "components_generated.h"
+#include "config_generated.h"
+#include "corgi/entity_manager.h"
+
+namespace fpl {
+namespace zooshi {
+
+struct World;
+
+// Instantiates a level's streamed entity files a piece at a time. Every
+// entity is assigned to a chunk of rail time by the point on the rail
+// closest to it, and only the chunks around the raft exist in the entity
+// manager. Chunks the raft has left behind are deleted, so the number of
+// live entities depends on the chunk settings rather than on the length of
+// the level.
+//
+// The streamed files stay resident, since the entities are re-created from
+// them whenever the raft comes back around. A re-created entity starts over
+// from its definition; nothing it did while loaded is kept. Only entities
+// with no gameplay state of their own, such as scenery props, should be
+// streamed. Entities without a transform can't be placed on the rail, so
+// they are created once and never recycled.
+//
+// Scene Lab calls StopStreaming() when it is entered, so that it sees and
+// saves every entity of the level.
+class LevelStreamer {
+ public:
+  LevelStreamer()
+      : rail_end_time_(0.0f),
+        chunk_time_(0.0f),
+        chunks_ahead_(0),
+        chunks_behind_(0),
+        wraps_(false),
+        raft_chunk_(-1),
+        loaded_chunk_count_(0),
+        resident_entity_count_(0) {}
+
+  // Forget every chunk, without deleting their entities. Call when the
+  // entity manager is about to be emptied anyway.
+  void Clear();
+
+  // Read the streamed entity files of `level_def` and partition them along
+  // the level's rail. The chunks around the raft's current position are
+  // created immediately. Must be called once the rest of the level is
+  // loaded and fixed up.
+  void Load(const LevelDef* level_def, World* world);
+
+  // Create and delete chunks to follow the raft. Cheap unless the raft has
+  // moved into a different chunk since the last call.
+  void Update(World* world);
+
+  // Create every chunk that isn't loaded and stop following the raft. The
+  // streamed entities then stay until the next level load.
+  void StopStreaming(World* world);
+
+  // True if the current level has anything to stream.
+  bool streaming() const { return !chunks_.empty(); }
+
+  size_t chunk_count() const { return chunks_.size(); }
+  size_t loaded_chunk_count() const { return loaded_chunk_count_; }
+  // Number of top-level entities currently created by the streamer.
+  size_t LoadedEntityCount() const;
+
+  // Bytes held by the resident files and the chunk tables.
+  size_t MemoryBytes() const;
+
+ private:
+  // An entity definition, and the index in files_ of the file it came from.
+  struct StreamedDef {
+    StreamedDef(const EntityDef* def, size_t file) : def(def), file(file) {}
+
+    const EntityDef* def;
+    size_t file;
+  };
+
+  struct Chunk {
+    Chunk() : loaded(false) {}
+
+    // Definitions in the resident files, in file order.
+    std::vector<StreamedDef> defs;
+    // The top-level entities created from `defs` while loaded.
+    std::vector<corgi::EntityRef> entities;
+    bool loaded;
+  };
+
+  // Whether `chunk` should exist while the raft is in `raft_chunk`.
+  bool ChunkWanted(int chunk, int raft_chunk) const;
+  void LoadChunk(Chunk* chunk, World* world);
+  void UnloadChunk(Chunk* chunk, World* world);
+  // Create an entity and apply the fixups LoadWorldDef would have applied.
+  corgi::EntityRef CreateEntity(const StreamedDef& def, World* world);
+
+  // Names and contents of the streamed files.
+  std::vector<std::string> filenames_;
+  std::vector<std::string> files_;
+  std::vector<Chunk> chunks_;
+  // Length of the rail the chunks were laid out along.
+  float rail_end_time_;
+  float chunk_time_;
+  int chunks_ahead_;
+  int chunks_behind_;
+  // Whether the rail wraps, so the first chunk follows the last one.
+  bool wraps_;
+  // Chunk the raft was in at the last Update(), or -1 if none yet.
+  int raft_chunk_;
+  size_t loaded_chunk_count_;
+  size_t resident_entity_count_;
+};
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_LEVEL_STREAMER_H_
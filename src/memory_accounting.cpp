@@ -0,0 +1,125 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "memory_accounting.h"
+
+#include <algorithm>
+#include "fplbase/utilities.h"
+
+namespace fpl {
+namespace zooshi {
+
+static const double kBytesPerKilobyte = 1024.0;
+
+void MemoryAccountant::Register(const char* name, const Reporter& reporter) {
+  reporters_.push_back(reporter);
+  usage_.push_back(MemoryUsage());
+  usage_.back().name = name;
+}
+
+void MemoryAccountant::SetBudgets(
+    const flatbuffers::Vector<flatbuffers::Offset<MemoryBudgetDef>>*
+        budgets) {
+  total_budget_ = 0;
+  for (auto it = usage_.begin(); it != usage_.end(); ++it) it->budget = 0;
+  if (budgets == nullptr) return;
+
+  for (auto def = budgets->begin(); def != budgets->end(); ++def) {
+    if (def->name() == nullptr) continue;
+    const std::string name = def->name()->str();
+    const size_t bytes = static_cast<size_t>(def->kilobytes()) * 1024;
+    if (name == kMemoryBudgetTotal) {
+      total_budget_ = bytes;
+      continue;
+    }
+    bool found = false;
+    for (auto it = usage_.begin(); it != usage_.end(); ++it) {
+      if (it->name == name) {
+        it->budget = bytes;
+        found = true;
+      }
+    }
+    if (!found) {
+      fplbase::LogError("MemoryAccountant: budget for unknown entry '%s'",
+                        name.c_str());
+    }
+  }
+}
+
+const std::vector<MemoryUsage>& MemoryAccountant::Snapshot() {
+  for (size_t i = 0; i < reporters_.size(); ++i) {
+    MemoryUsage& usage = usage_[i];
+    usage.bytes = reporters_[i]();
+    usage.high_water_mark = std::max(usage.high_water_mark, usage.bytes);
+
+    const bool over_budget = usage.budget != 0 && usage.bytes > usage.budget;
+    if (over_budget && !usage.over_budget) {
+      fplbase::LogError("Memory budget exceeded: %s uses %.1fKB of %.1fKB",
+                        usage.name.c_str(), usage.bytes / kBytesPerKilobyte,
+                        usage.budget / kBytesPerKilobyte);
+    }
+    usage.over_budget = over_budget;
+  }
+
+  const size_t total = total_bytes();
+  const bool total_over_budget = total_budget_ != 0 && total > total_budget_;
+  if (total_over_budget && !total_over_budget_) {
+    fplbase::LogError("Memory budget exceeded: %s is %.1fKB of %.1fKB",
+                      kMemoryBudgetTotal, total / kBytesPerKilobyte,
+                      total_budget_ / kBytesPerKilobyte);
+  }
+  total_over_budget_ = total_over_budget;
+  return usage_;
+}
+
+void MemoryAccountant::AdvanceFrame() {
+  if (--frames_until_sample_ > 0) return;
+  frames_until_sample_ = kMemorySampleFrames;
+  Snapshot();
+}
+
+void MemoryAccountant::LogSnapshot(const char* reason) {
+  Snapshot();
+
+  std::vector<const MemoryUsage*> sorted;
+  sorted.reserve(usage_.size());
+  for (auto it = usage_.begin(); it != usage_.end(); ++it) {
+    sorted.push_back(&*it);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const MemoryUsage* a, const MemoryUsage* b) {
+              return a->bytes > b->bytes;
+            });
+
+  fplbase::LogInfo("Memory snapshot (%s): %.1fKB total", reason,
+                   total_bytes() / kBytesPerKilobyte);
+  for (auto it = sorted.begin(); it != sorted.end(); ++it) {
+    const MemoryUsage& usage = **it;
+    fplbase::LogInfo("  %-24s %10.1fKB  peak %10.1fKB%s", usage.name.c_str(),
+                     usage.bytes / kBytesPerKilobyte,
+                     usage.high_water_mark / kBytesPerKilobyte,
+                     usage.over_budget ? "  OVER BUDGET" : "");
+  }
+}
+
+size_t MemoryAccountant::total_bytes() const {
+  size_t total = 0;
+  for (auto it = usage_.begin(); it != usage_.end(); ++it) {
+    total += it->bytes;
+  }
+  return total;
+}
+
+}  // zooshi
+}  // fpl
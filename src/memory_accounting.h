@@ -0,0 +1,124 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_MEMORY_ACCOUNTING_H_
+#define ZOOSHI_MEMORY_ACCOUNTING_H_
+
+#include <stddef.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "config_generated.h"
+
+namespace fpl {
+namespace zooshi {
+
+// Name of the budget that applies to the sum of every reporter.
+static const char kMemoryBudgetTotal[] = "total";
+
+// Frames between the periodic snapshots taken by AdvanceFrame(). Some
+// reporters walk every entity of a component, so polling every frame is
+// wasted work.
+static const int kMemorySampleFrames = 30;
+
+// One line of a memory snapshot.
+struct MemoryUsage {
+  MemoryUsage() : bytes(0), high_water_mark(0), budget(0), over_budget(false) {}
+
+  std::string name;
+  // Bytes owned at the time of the last snapshot.
+  size_t bytes;
+  // Largest `bytes` seen in any snapshot so far, periodic ones included.
+  size_t high_water_mark;
+  // Bytes allowed, or 0 for no budget.
+  size_t budget;
+  // Whether the last snapshot exceeded the budget. Used so that a warning is
+  // logged once per crossing rather than on every snapshot.
+  bool over_budget;
+};
+
+// Collects how much memory each subsystem owns. Subsystems register a
+// reporter that returns their current byte count; Snapshot() polls them all,
+// updates high-water marks, and logs a warning whenever a configured budget
+// is exceeded. AdvanceFrame() takes a snapshot every few frames so that
+// peaks between explicit snapshots are not missed.
+//
+// Reporters read live game state, so snapshots must be taken while holding
+// the game update lock.
+class MemoryAccountant {
+ public:
+  typedef std::function<size_t()> Reporter;
+
+  MemoryAccountant()
+      : total_budget_(0), total_over_budget_(false), frames_until_sample_(0) {}
+
+  void Register(const char* name, const Reporter& reporter);
+
+  // Apply budgets from config. Entries are matched to reporters by name; the
+  // entry named kMemoryBudgetTotal applies to the sum of all of them.
+  void SetBudgets(
+      const flatbuffers::Vector<flatbuffers::Offset<MemoryBudgetDef>>*
+          budgets);
+
+  // Poll every reporter and check budgets.
+  const std::vector<MemoryUsage>& Snapshot();
+
+  // Call once per frame. Takes a snapshot every kMemorySampleFrames calls.
+  void AdvanceFrame();
+
+  // Take a snapshot and write it to the log, largest first.
+  void LogSnapshot(const char* reason);
+
+  // Results of the last snapshot.
+  const std::vector<MemoryUsage>& usage() const { return usage_; }
+  size_t total_bytes() const;
+
+ private:
+  std::vector<Reporter> reporters_;
+  std::vector<MemoryUsage> usage_;
+  size_t total_budget_;
+  bool total_over_budget_;
+  int frames_until_sample_;
+};
+
+// Number of entities registered with a corgi component.
+template <typename ComponentT>
+size_t ComponentEntityCount(ComponentT* component) {
+  size_t count = 0;
+  for (auto iter = component->begin(); iter != component->end(); ++iter) {
+    ++count;
+  }
+  return count;
+}
+
+// Bytes used by the per-entity data of a corgi component. This counts the
+// data structs only; reporters add anything the data points to.
+template <typename ComponentT>
+size_t ComponentDataBytes(ComponentT* component) {
+  return ComponentEntityCount(component) * sizeof(*component->begin());
+}
+
+// Register a reporter for the per-entity data of `component`.
+template <typename ComponentT>
+void RegisterComponentMemory(MemoryAccountant* accountant, const char* name,
+                             ComponentT* component) {
+  accountant->Register(
+      name, [component]() { return ComponentDataBytes(component); });
+}
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_MEMORY_ACCOUNTING_H_
@@ -34,6 +34,33 @@ using corgi::EntityRef;
 namespace fpl {
 namespace zooshi {
 
+// Fires a pulse on frames where any of the entity's attributes changed.
+class OnAttributesChangedNode : public BaseNode {
+ public:
+  OnAttributesChangedNode(GraphComponent* graph_component)
+      : graph_component_(graph_component) {}
+  virtual ~OnAttributesChangedNode() {}
+
+  static void OnRegister(NodeSignature* node_sig) {
+    node_sig->AddInput<EntityRef>();
+    node_sig->AddOutput<void>();
+    node_sig->AddListener(kAttributesChangedEventId);
+  }
+
+  virtual void Initialize(NodeArguments* args) {
+    auto entity = args->GetInput<EntityRef>(0);
+    args->BindBroadcaster(0, graph_component_->GetCreateBroadcaster(*entity));
+  }
+
+  virtual void Execute(NodeArguments* args) {
+    Initialize(args);
+    args->SetOutput(0);
+  }
+
+ private:
+  GraphComponent* graph_component_;
+};
+
 // Returns the value of the given attribute.
 class GetAttributeNode : public BaseNode {
  public:
@@ -52,9 +79,9 @@ class GetAttributeNode : public BaseNode {
     if (args->IsInputDirty(0)) {
       auto entity = args->GetInput<EntityRef>(1);
       auto index = args->GetInput<int>(2);
-      auto attributes_data = attributes_component_->GetComponentData(*entity);
-      if (attributes_data) {
-        args->SetOutput(0, attributes_data->attributes[*index]);
+      if (attributes_component_->GetComponentData(*entity)) {
+        args->SetOutput(0, attributes_component_->GetAttribute(
+                               *entity, static_cast<AttributeDef>(*index)));
       }
     }
   }
@@ -82,9 +109,9 @@ class SetAttributeNode : public BaseNode {
       auto entity = args->GetInput<EntityRef>(1);
       auto index = args->GetInput<int>(2);
       auto value = args->GetInput<float>(3);
-      auto attributes_data = attributes_component_->GetComponentData(*entity);
-      if (attributes_data) {
-        attributes_data->attributes[*index] = *value;
+      if (attributes_component_->GetComponentData(*entity)) {
+        attributes_component_->SetAttribute(
+            *entity, static_cast<AttributeDef>(*index), *value);
       }
     }
   }
@@ -94,7 +121,11 @@ class SetAttributeNode : public BaseNode {
 };
 
 void InitializeAttributesModule(ModuleRegistry* module_registry,
-                                AttributesComponent* attributes_component) {
+                                AttributesComponent* attributes_component,
+                                GraphComponent* graph_component) {
+  auto on_attributes_changed_ctor = [graph_component]() {
+    return new OnAttributesChangedNode(graph_component);
+  };
   auto get_attribute_ctor = [attributes_component]() {
     return new GetAttributeNode(attributes_component);
   };
@@ -102,6 +133,8 @@ void InitializeAttributesModule(ModuleRegistry* module_registry,
     return new SetAttributeNode(attributes_component);
   };
   Module* module = module_registry->RegisterModule("attributes");
+  module->RegisterNode<OnAttributesChangedNode>("on_attributes_changed",
+                                                on_attributes_changed_ctor);
   module->RegisterNode<GetAttributeNode>("get_attribute", get_attribute_ctor);
   module->RegisterNode<SetAttributeNode>("set_attribute", set_attribute_ctor);
 }
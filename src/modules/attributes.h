@@ -22,8 +22,10 @@
 namespace fpl {
 namespace zooshi {
 
-void InitializeAttributesModule(breadboard::ModuleRegistry* module_registry,
-                                AttributesComponent* attributes_component);
+void InitializeAttributesModule(
+    breadboard::ModuleRegistry* module_registry,
+    AttributesComponent* attributes_component,
+    corgi::component_library::GraphComponent* graph_component);
 
 }  // zooshi
 }  // fpl
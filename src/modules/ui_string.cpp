@@ -54,7 +54,9 @@ class Set3dTextStringNode : public BaseNode {
     const auto text = args->GetInput<std::string>(kInputString);
     Render3dTextData* render_3d_text_data =
         render_3d_text_component_->GetComponentData(*entity);
-    if (render_3d_text_data) {
+    // Skip the copy when the string is unchanged; upstream graphs often
+    // rebuild the same string.
+    if (render_3d_text_data && render_3d_text_data->text != *text) {
       render_3d_text_data->text = *text;
     }
   }
@@ -0,0 +1,127 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "multiplayer_message_queue.h"
+
+#include <string.h>
+
+namespace fpl {
+
+MultiplayerMessageQueue::MultiplayerMessageQueue()
+    : arena_(kArenaSize),
+      arena_write_(0),
+      arena_read_(0),
+      popped_end_(0),
+      has_popped_(false),
+      dropped_count_(0),
+      instance_count_(0) {}
+
+MultiplayerMessageQueue::InstanceHandle
+MultiplayerMessageQueue::FindInstanceId(const std::string& instance_id) const {
+  const size_t count = instance_count_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < count; ++i) {
+    if (instance_ids_[i] == instance_id) {
+      return static_cast<InstanceHandle>(i);
+    }
+  }
+  return kInvalidInstance;
+}
+
+MultiplayerMessageQueue::InstanceHandle
+MultiplayerMessageQueue::InternInstanceId(const std::string& instance_id) {
+  InstanceHandle handle = FindInstanceId(instance_id);
+  if (handle != kInvalidInstance) return handle;
+
+  std::lock_guard<std::mutex> lock(intern_mutex_);
+  // Someone else may have interned it while we waited for the lock.
+  handle = FindInstanceId(instance_id);
+  if (handle != kInvalidInstance) return handle;
+  const size_t count = instance_count_.load(std::memory_order_relaxed);
+  if (count == kMaxInstances) return kInvalidInstance;
+  instance_ids_[count] = instance_id;
+  instance_count_.store(count + 1, std::memory_order_release);
+  return static_cast<InstanceHandle>(count);
+}
+
+bool MultiplayerMessageQueue::Push(InstanceHandle sender,
+                                   const uint8_t* payload, size_t size,
+                                   bool reliable) {
+  // Payloads are stored contiguously, so one that would run off the end of
+  // the arena starts again at the beginning instead.
+  size_t start = arena_write_;
+  const size_t offset = start % kArenaSize;
+  if (offset + size > kArenaSize) start += kArenaSize - offset;
+  const size_t end = start + size;
+  if (size > kArenaSize ||
+      end - arena_read_.load(std::memory_order_acquire) > kArenaSize) {
+    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  Descriptor descriptor;
+  descriptor.offset = static_cast<uint32_t>(start % kArenaSize);
+  descriptor.size = static_cast<uint32_t>(size);
+  descriptor.arena_end = end;
+  descriptor.sender = sender;
+  descriptor.reliable = reliable;
+  if (size > 0) memcpy(&arena_[descriptor.offset], payload, size);
+  if (!descriptors_.Push(descriptor)) {
+    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  arena_write_ = end;
+  return true;
+}
+
+bool MultiplayerMessageQueue::Pop(Message* message) {
+  ReleasePopped();
+  Descriptor descriptor;
+  if (!descriptors_.Pop(&descriptor)) return false;
+  message->sender = descriptor.sender;
+  message->reliable = descriptor.reliable;
+  message->payload = &arena_[descriptor.offset];
+  message->size = descriptor.size;
+  popped_end_ = descriptor.arena_end;
+  has_popped_ = true;
+  return true;
+}
+
+void MultiplayerMessageQueue::Clear() {
+  Descriptor descriptor;
+  while (descriptors_.Pop(&descriptor)) {
+    popped_end_ = descriptor.arena_end;
+    has_popped_ = true;
+  }
+  ReleasePopped();
+}
+
+void MultiplayerMessageQueue::ClearInstanceIds() {
+  // Waiting messages refer to the handles being forgotten.
+  Clear();
+  std::lock_guard<std::mutex> lock(intern_mutex_);
+  const size_t count = instance_count_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < count; ++i) {
+    instance_ids_[i].clear();
+  }
+  instance_count_.store(0, std::memory_order_release);
+}
+
+void MultiplayerMessageQueue::ReleasePopped() {
+  if (has_popped_) {
+    arena_read_.store(popped_end_, std::memory_order_release);
+    has_popped_ = false;
+  }
+}
+
+}  // namespace fpl
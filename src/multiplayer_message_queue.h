@@ -0,0 +1,141 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTIPLAYER_MESSAGE_QUEUE_H
+#define MULTIPLAYER_MESSAGE_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "spsc_queue.h"
+
+namespace fpl {
+
+// Passes incoming multiplayer messages from the thread that receives them to
+// the thread that handles them, without locking or allocating.
+//
+// Each message is described by a small fixed-size descriptor in a
+// single-producer/single-consumer ring. The payload itself is copied once,
+// into a byte arena that is used as a ring too: since messages are consumed
+// in the order they were received, payload space is reclaimed simply by
+// moving the arena's read position past each message once it is handled.
+//
+// Senders are identified by small integer handles rather than by their
+// instance ID strings. Instance IDs are interned the first time they are
+// seen, and a handle stays valid until ClearInstanceIds() is called.
+class MultiplayerMessageQueue {
+ public:
+  typedef uint16_t InstanceHandle;
+  static const InstanceHandle kInvalidInstance = 0xFFFF;
+
+  // The most messages that can be waiting at once.
+  static const size_t kMaxMessages = 256;
+  // Bytes of payload storage shared by all waiting messages.
+  static const size_t kArenaSize = 256 * 1024;
+  // The most distinct instance IDs that can be interned.
+  static const size_t kMaxInstances = 64;
+
+  // A received message. `payload` points into the queue's arena and stays
+  // valid until the next call to Pop() or Clear().
+  struct Message {
+    InstanceHandle sender;
+    bool reliable;
+    const uint8_t* payload;
+    size_t size;
+  };
+
+  MultiplayerMessageQueue();
+
+  // Returns the handle for `instance_id`, interning it if it is new. Finding
+  // an existing ID is lock-free and may be done from any thread; interning a
+  // new one takes a lock. Returns kInvalidInstance if the table is full.
+  InstanceHandle InternInstanceId(const std::string& instance_id);
+
+  // Returns the handle for `instance_id`, or kInvalidInstance if it has never
+  // been interned. Lock-free.
+  InstanceHandle FindInstanceId(const std::string& instance_id) const;
+
+  // The instance ID a handle was interned from.
+  const std::string& instance_id(InstanceHandle handle) const {
+    return instance_ids_[handle];
+  }
+
+  // Producer side. Copy a message into the queue. Returns false, dropping the
+  // message, if there is no room for it.
+  bool Push(InstanceHandle sender, const uint8_t* payload, size_t size,
+            bool reliable);
+
+  // Consumer side. Release the previously popped message and fetch the next.
+  // Returns false if there are no more messages.
+  bool Pop(Message* message);
+
+  // Consumer side. Discard every waiting message.
+  void Clear();
+
+  // Discard every waiting message and forget every interned instance ID, so
+  // that a new session starts with the whole table free. Only call this when
+  // no other thread can be pushing or interning, e.g. once every connection
+  // has been closed.
+  void ClearInstanceIds();
+
+  bool empty() const { return descriptors_.empty(); }
+  // The number of messages Push() has had to drop.
+  size_t dropped_count() const {
+    return dropped_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Descriptor {
+    // Byte offset of the payload in arena_.
+    uint32_t offset;
+    uint32_t size;
+    // The arena write position once this message was added. Reaching it
+    // releases the message's payload and any padding before it.
+    size_t arena_end;
+    InstanceHandle sender;
+    bool reliable;
+  };
+
+  // Not copyable.
+  MultiplayerMessageQueue(const MultiplayerMessageQueue&);
+  MultiplayerMessageQueue& operator=(const MultiplayerMessageQueue&);
+
+  void ReleasePopped();
+
+  zooshi::SpscQueue<Descriptor, kMaxMessages> descriptors_;
+  std::vector<uint8_t> arena_;
+  // Running byte counts, not offsets; the offset is the count modulo
+  // kArenaSize. arena_write_ belongs to the producer, arena_read_ is
+  // advanced by the consumer.
+  size_t arena_write_;
+  std::atomic<size_t> arena_read_;
+  // The arena_end of the message last returned by Pop(), if any.
+  size_t popped_end_;
+  bool has_popped_;
+  std::atomic<size_t> dropped_count_;
+
+  // Append-only until ClearInstanceIds(). An entry is written before
+  // instance_count_ is raised past it, so readers that load instance_count_
+  // see complete strings.
+  std::string instance_ids_[kMaxInstances];
+  std::atomic<size_t> instance_count_;
+  std::mutex intern_mutex_;
+};
+
+}  // namespace fpl
+
+#endif  // MULTIPLAYER_MESSAGE_QUEUE_H
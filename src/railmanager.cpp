@@ -14,7 +14,8 @@
 
 #include "railmanager.h"
 
-#include <map>
+#include <limits>
+
 #include "components/rail_denizen.h"
 #include "components/rail_node.h"
 #include "corgi_component_library/transform.h"
@@ -35,27 +36,34 @@ using mathfu::vec3_packed;
 void Rail::Initialize(const RailDef *rail_def, float spline_granularity) {
   // Allocate temporary memory for the positions and derivative arrays.
   const int num_positions = static_cast<int>(rail_def->positions()->Length());
-  std::vector<vec3_packed> positions;
-  positions.resize(num_positions);
+  FrameVector<vec3_packed> positions(num_positions);
 
   // Load positions.
   for (int i = 0; i < num_positions; ++i) {
     positions[i] = LoadVec3(rail_def->positions()->Get(i));
   }
-  InitializeFromPositions(positions, spline_granularity,
-                          rail_def->reliable_distance(), rail_def->total_time(),
-                          rail_def->wraps());
+  InitializeFromPositions(positions.data(), positions.size(),
+                          spline_granularity, rail_def->reliable_distance(),
+                          rail_def->total_time(), rail_def->wraps());
 }
 
-void Rail::InitializeFromPositions(const std::vector<vec3_packed> &positions,
+void Rail::InitializeFromPositions(const vec3_packed *positions,
+                                   size_t num_positions,
                                    float spline_granularity,
                                    float reliable_distance, float total_time,
                                    bool wraps) {
-  const size_t num_positions = positions.size();
-  std::vector<float> times;
-  std::vector<vec3_packed> derivatives;
-  times.resize(num_positions);
-  derivatives.resize(num_positions);
+  // Each position becomes two nodes, which are indexed with
+  // CompactSplineIndex.
+  const size_t max_positions =
+      std::numeric_limits<motive::CompactSplineIndex>::max() / 2;
+  if (num_positions > max_positions) {
+    fplbase::LogError("Rail has %d nodes; only the first %d are used.",
+                      static_cast<int>(num_positions),
+                      static_cast<int>(max_positions));
+    num_positions = max_positions;
+  }
+  FrameVector<float> times(num_positions);
+  FrameVector<vec3_packed> derivatives(num_positions);
   wraps_ = wraps;
 
   // Calculate derivates and times from positions.
@@ -66,15 +74,16 @@ void Rail::InitializeFromPositions(const std::vector<vec3_packed> &positions,
   // Get position extremes.
   vec3 position_min(std::numeric_limits<float>::infinity());
   vec3 position_max(-std::numeric_limits<float>::infinity());
-  for (auto p = positions.begin(); p != positions.end(); ++p) {
-    const vec3 position(*p);
+  for (size_t k = 0; k < num_positions; ++k) {
+    const vec3 position(positions[k]);
     position_min = vec3::Min(position_min, position);
     position_max = vec3::Max(position_max, position);
   }
 
   // Create array of splines. Destroyed in Rail's destructor.
+  spline_nodes_ = 2 * num_positions;
   splines_ = motive::CompactSpline::CreateArray(
-      2 * static_cast<motive::CompactSplineIndex>(num_positions), kDimensions);
+      static_cast<motive::CompactSplineIndex>(spline_nodes_), kDimensions);
 
   // Initialize the compact-splines to have the best precision possible,
   // given the range limits.
@@ -98,6 +107,13 @@ void Rail::InitializeFromPositions(const std::vector<vec3_packed> &positions,
   }
 }
 
+size_t Rail::MemoryBytes() const {
+  // Each compact spline node is three quantized 16-bit values.
+  static const size_t kBytesPerSplineNode = 3 * sizeof(uint16_t);
+  return sizeof(*this) + kDimensions * (sizeof(motive::CompactSpline) +
+                                        spline_nodes_ * kBytesPerSplineNode);
+}
+
 Rail *RailManager::GetRail(RailId rail_file) {
   if (rail_map.find(rail_file) == rail_map.end()) {
     // New rail, so we load it up:
@@ -114,7 +130,8 @@ Rail *RailManager::GetRail(RailId rail_file) {
 
 Rail *RailManager::GetRailFromComponents(const char *rail_name,
                                          corgi::EntityManager *entity_manager) {
-  std::map<float, corgi::EntityRef> rail_entities;
+  // Both containers are temporaries, so keep them in the frame arena.
+  FrameMap<float, corgi::EntityRef> rail_entities;
 
   auto *rail_component = entity_manager->GetComponent<RailNodeComponent>();
   for (auto i = rail_component->begin(); i != rail_component->end(); ++i) {
@@ -130,7 +147,7 @@ Rail *RailManager::GetRailFromComponents(const char *rail_name,
     return nullptr;  // invalid rail name
   }
 
-  std::vector<vec3_packed> positions;
+  FrameVector<vec3_packed> positions;
   const RailNodeData *first_data =
       rail_component->GetComponentData(rail_entities.begin()->second);
   // Extract the total time and reliable distance from the first-listed
@@ -156,8 +173,9 @@ Rail *RailManager::GetRailFromComponents(const char *rail_name,
 
   // Create a new rail with the requested positions.
   Rail *new_rail = new Rail();
-  new_rail->InitializeFromPositions(
-      positions, kSplineGranularity, reliable_distance, total_time, wraps);
+  new_rail->InitializeFromPositions(positions.data(), positions.size(),
+                                    kSplineGranularity, reliable_distance,
+                                    total_time, wraps);
 
   // Update anything that may be using the old rail.
   auto old_rail = rail_map.find(rail_name);
@@ -174,5 +192,13 @@ Rail *RailManager::GetRailFromComponents(const char *rail_name,
 
 void RailManager::Clear() { rail_map.clear(); }
 
+size_t RailManager::MemoryBytes() const {
+  size_t bytes = 0;
+  for (auto it = rail_map.begin(); it != rail_map.end(); ++it) {
+    bytes += it->first.capacity() + it->second->MemoryBytes();
+  }
+  return bytes;
+}
+
 }  // zooshi
 }  // fpl
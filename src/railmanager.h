@@ -15,10 +15,12 @@
 #ifndef RAILMANAGER_H
 #define RAILMANAGER_H
 
+#include <cmath>
 #include <memory>
 #include <unordered_map>
 #include "components_generated.h"
 #include "corgi/entity_manager.h"
+#include "frame_arena.h"
 #include "mathfu/glsl_mappings.h"
 #include "motive/math/compact_spline.h"
 #include "rail_def_generated.h"
@@ -30,16 +32,24 @@ typedef std::string RailId;
 
 class Rail {
  public:
-  Rail() : splines_(nullptr), wraps_(true) {}
+  Rail() : splines_(nullptr), spline_nodes_(0), wraps_(true) {}
   ~Rail() { motive::CompactSpline::DestroyArray(splines_, kDimensions); }
 
   void Initialize(const RailDef* rail_def, float spline_granularity);
 
   /// Return vector of `positions` that is the rail evaluated every `delta_time`
   /// for the entire course of the rail. This calculation is much faster than
-  /// calling PositionCalculatedSlowly() multiple times.
+  /// calling PositionCalculatedSlowly() multiple times. `positions` may use
+  /// any allocator, so callers can evaluate into a FrameVector.
+  template <typename Allocator>
   void Positions(float delta_time,
-                 std::vector<mathfu::vec3_packed>* positions) const;
+                 std::vector<mathfu::vec3_packed, Allocator>* positions) const {
+    const size_t num_positions =
+        static_cast<size_t>(std::floor(EndTime() / delta_time)) + 1;
+    positions->resize(num_positions);
+    motive::CompactSpline::BulkYs<3>(Splines(), 0.0f, delta_time,
+                                     num_positions, &(*positions)[0]);
+  }
 
   /// Return the rail position at `time`. This calculation is fairly slow
   /// so only use outside a loop. If you need a series of positions, consider
@@ -53,13 +63,16 @@ class Rail {
   const motive::CompactSpline* Splines() const { return splines_; }
 
   void InitializeFromPositions(
-      const std::vector<mathfu::vec3_packed>& positions,
+      const mathfu::vec3_packed* positions, size_t num_positions,
       float spline_granularity, float reliable_distance, float total_time,
       bool wraps);
 
   /// Does the rail wrap around to itself at the end.
   bool wraps() const { return wraps_; }
 
+  /// Approximate bytes held by the rail's splines.
+  size_t MemoryBytes() const;
+
  private:
   static const motive::MotiveDimension kDimensions = 3;
 
@@ -71,6 +84,9 @@ class Rail {
   // Points to the first of kDimension splines in contiguous memory.
   motive::CompactSpline* splines_;
 
+  // Number of nodes allocated in each spline.
+  size_t spline_nodes_;
+
   // Does the rail wrap around to itself at the end.
   bool wraps_;
 };
@@ -89,6 +105,9 @@ class RailManager {
 
   void Clear();
 
+  // Approximate bytes held by every cached rail.
+  size_t MemoryBytes() const;
+
  private:
   std::unordered_map<RailId, std::unique_ptr<Rail>> rail_map;
 };
@@ -37,12 +37,17 @@ const char* kConfigMenuSendInvite = "menu_send_invite";
 const char* kConfigMenuOfferVideo = "menu_offer_video";
 
 // Can't use this lambda on Visual Studio 2010, so make a function.
-void FetchCompletion(const firebase::Future<void>& /*completed_future*/,
-                     void* /*data*/) {
+// static
+void RemoteConfig::FetchCompletion(
+    const firebase::Future<void>& /*completed_future*/, void* void_config) {
   firebase::remote_config::ActivateFetched();
+  static_cast<RemoteConfig*>(void_config)->fetched_.store(
+      true, std::memory_order_release);
 }
 
-void InitializeRemoteConfig(const firebase::App& app) {
+void RemoteConfig::Initialize(const firebase::App& app,
+                              SaveManager* save_manager) {
+  save_manager_ = save_manager;
   firebase::remote_config::Initialize(app);
 
   // Set the default values.
@@ -57,8 +62,39 @@ void InitializeRemoteConfig(const firebase::App& app) {
   size_t default_count = sizeof(defaults) / sizeof(defaults[0]);
   firebase::remote_config::SetDefaults(defaults, default_count);
 
+  if (save_manager_->has_remote_config()) {
+    values_ = save_manager_->remote_config();
+  } else {
+    values_.rewarded_video_location = 0;
+    values_.menu_play_game = defaults[1].value;
+    values_.menu_send_invite = defaults[2].value;
+    values_.menu_offer_video = defaults[3].value;
+  }
+  published_ = values_;
+
   firebase::remote_config::Fetch(kRemoteConfigCacheTime).OnCompletion(
-      FetchCompletion, nullptr);
+      FetchCompletion, this);
+}
+
+void RemoteConfig::Update() {
+  if (!fetched_.exchange(false, std::memory_order_acquire)) return;
+
+  values_.rewarded_video_location =
+      firebase::remote_config::GetLong(kConfigRewardedVideoLocation);
+  values_.menu_play_game =
+      firebase::remote_config::GetString(kConfigMenuPlayGame);
+  values_.menu_send_invite =
+      firebase::remote_config::GetString(kConfigMenuSendInvite);
+  values_.menu_offer_video =
+      firebase::remote_config::GetString(kConfigMenuOfferVideo);
+  save_manager_->set_remote_config(values_);
+  values_changed_ = true;
+}
+
+void RemoteConfig::Latch() {
+  if (!values_changed_) return;
+  published_ = values_;
+  values_changed_ = false;
 }
 
 }  // zooshi
@@ -15,7 +15,12 @@
 #ifndef ZOOSHI_REMOTE_CONFIG_H_
 #define ZOOSHI_REMOTE_CONFIG_H_
 
+#include <atomic>
+#include <string>
+
 #include "firebase/app.h"
+#include "firebase/future.h"
+#include "save_manager.h"
 
 namespace fpl {
 namespace zooshi {
@@ -28,7 +33,61 @@ extern const char* kConfigMenuPlayGame;
 extern const char* kConfigMenuSendInvite;
 extern const char* kConfigMenuOfferVideo;
 
-void InitializeRemoteConfig(const firebase::App& app);
+// A snapshot of the remote config values the game uses. The SDK is only
+// queried when a fetch has been activated; everything else reads the
+// snapshot, so the accessors are cheap enough to call every frame and never
+// allocate. The last activated values are kept in the save file, so a cold
+// start shows them before its own fetch completes.
+//
+// The snapshot is double buffered. Update() runs on the update thread and
+// fills a copy of its own. Latch() publishes that copy to the accessors, and
+// must be called on the render thread with the game update mutex held. The
+// accessors can then be read from the render thread at any time, including
+// from HandleUI(), and from the update thread.
+class RemoteConfig {
+ public:
+  RemoteConfig()
+      : save_manager_(nullptr), fetched_(false), values_changed_(false) {}
+
+  // Set the defaults, load the last activated values and start a fetch.
+  void Initialize(const firebase::App& app, SaveManager* save_manager);
+
+  // If a fetch has been activated since the last call, copy its values and
+  // persist them. They are published by the next Latch(). Call once per
+  // frame on the update thread.
+  void Update();
+
+  // Publish the values from the last Update() that activated a fetch. Only
+  // copies when there is something new.
+  void Latch();
+
+  int64_t rewarded_video_location() const {
+    return published_.rewarded_video_location;
+  }
+  const std::string& menu_play_game() const {
+    return published_.menu_play_game;
+  }
+  const std::string& menu_send_invite() const {
+    return published_.menu_send_invite;
+  }
+  const std::string& menu_offer_video() const {
+    return published_.menu_offer_video;
+  }
+
+ private:
+  static void FetchCompletion(const firebase::Future<void>& completed_future,
+                              void* void_config);
+
+  // Written by Update(), and read by Latch() under the update mutex.
+  SaveRemoteConfig values_;
+  // Only written by Latch(), so the render thread can read it unlocked.
+  SaveRemoteConfig published_;
+  SaveManager* save_manager_;
+  // Set by FetchCompletion() on an SDK thread, consumed by Update().
+  std::atomic<bool> fetched_;
+  // Set by Update() when values_ changed, cleared by Latch().
+  bool values_changed_;
+};
 
 }  // zooshi
 }  // fpl
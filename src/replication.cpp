@@ -0,0 +1,307 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "replication.h"
+
+#include <math.h>
+#include <algorithm>
+
+#include "mathfu/utilities.h"
+
+namespace fpl {
+namespace zooshi {
+
+// Scale for the three smallest quaternion components, which all lie within
+// +/-1/sqrt(2).
+static const float kQuatComponentScale = 32767.0f * 1.41421356f;
+
+static int16_t QuantizeComponent(float value) {
+  const float clamped = mathfu::Clamp(value, -32768.0f, 32767.0f);
+  return static_cast<int16_t>(floorf(clamped + 0.5f));
+}
+
+QuantizedVec3 QuantizeVec3(const mathfu::vec3& v, float scale) {
+  return QuantizedVec3(QuantizeComponent(v.x() * scale),
+                       QuantizeComponent(v.y() * scale),
+                       QuantizeComponent(v.z() * scale));
+}
+
+mathfu::vec3 DequantizeVec3(const QuantizedVec3& q, float scale) {
+  return mathfu::vec3(q.x(), q.y(), q.z()) / scale;
+}
+
+QuantizedQuat QuantizeQuat(const mathfu::quat& q) {
+  float c[4] = {q.scalar(), q.vector().x(), q.vector().y(), q.vector().z()};
+  int largest = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (fabsf(c[i]) > fabsf(c[largest])) largest = i;
+  }
+  // q and -q are the same rotation, so make the dropped component positive
+  // and it can be rebuilt without storing its sign.
+  const float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+  int16_t smallest[3];
+  for (int i = 0, j = 0; i < 4; ++i) {
+    if (i != largest) {
+      smallest[j++] = QuantizeComponent(c[i] * sign * kQuatComponentScale);
+    }
+  }
+  return QuantizedQuat(smallest[0], smallest[1], smallest[2],
+                       static_cast<uint8_t>(largest));
+}
+
+mathfu::quat DequantizeQuat(const QuantizedQuat& q) {
+  const float smallest[3] = {q.a() / kQuatComponentScale,
+                             q.b() / kQuatComponentScale,
+                             q.c() / kQuatComponentScale};
+  const float sum_of_squares = smallest[0] * smallest[0] +
+                               smallest[1] * smallest[1] +
+                               smallest[2] * smallest[2];
+  float c[4];
+  for (int i = 0, j = 0; i < 4; ++i) {
+    c[i] = i == q.largest() ? sqrtf(std::max(0.0f, 1.0f - sum_of_squares))
+                            : smallest[j++];
+  }
+  return mathfu::quat(c[0], c[1], c[2], c[3]).Normalized();
+}
+
+bool operator==(const QuantizedVec3& a, const QuantizedVec3& b) {
+  return a.x() == b.x() && a.y() == b.y() && a.z() == b.z();
+}
+
+bool operator==(const QuantizedQuat& a, const QuantizedQuat& b) {
+  return a.a() == b.a() && a.b() == b.b() && a.c() == b.c() &&
+         a.largest() == b.largest();
+}
+
+bool RaftSnapshot::operator==(const RaftSnapshot& other) const {
+  return lap_number == other.lap_number &&
+         total_lap_progress == other.total_lap_progress &&
+         position == other.position && orientation == other.orientation;
+}
+
+bool PatronSnapshot::operator==(const PatronSnapshot& other) const {
+  return state == other.state && position == other.position &&
+         orientation == other.orientation;
+}
+
+void LoopbackReplicationTransport::Connect(LoopbackReplicationTransport* a,
+                                           LoopbackReplicationTransport* b) {
+  a->other_ = b;
+  b->other_ = a;
+}
+
+void LoopbackReplicationTransport::Send(int /*peer*/, const uint8_t* data,
+                                        size_t size) {
+  if (other_ == nullptr) return;
+  random_state_ = random_state_ * 1664525u + 1013904223u;
+  const float random = (random_state_ >> 8) / 16777216.0f;
+  if (random < loss_rate_) return;
+  other_->inbox_.push_back(std::vector<uint8_t>(data, data + size));
+}
+
+bool LoopbackReplicationTransport::Receive(int* peer,
+                                           std::vector<uint8_t>* data) {
+  if (inbox_.empty()) return false;
+  *peer = 0;
+  data->swap(inbox_.front());
+  inbox_.pop_front();
+  return true;
+}
+
+ReplicationSession::ReplicationSession(ReplicationTransport* transport)
+    : transport_(transport),
+      peers_(transport->peer_count()),
+      tick_(1),
+      next_spawn_id_(1),
+      bandwidth_window_start_(0),
+      bytes_sent_in_window_(0),
+      bytes_received_in_window_(0),
+      bytes_sent_per_second_(0),
+      bytes_received_per_second_(0),
+      last_packet_size_(0) {}
+
+void ReplicationSession::AddProjectileSpawn(const ProjectileSpawn& spawn) {
+  PendingSpawn pending;
+  pending.tick = tick_;
+  pending.spawn =
+      ProjectileSpawn(next_spawn_id_++, spawn.sushi_index(), spawn.position(),
+                      spawn.velocity(), spawn.orientation());
+  pending_spawns_.push_back(pending);
+}
+
+void ReplicationSession::Tick(uint32_t time) {
+  local_.tick = tick_;
+  for (size_t i = 0; i < peers_.size(); ++i) {
+    Encode(&peers_[i]);
+    transport_->Send(static_cast<int>(i), fbb_.GetBufferPointer(),
+                     fbb_.GetSize());
+    last_packet_size_ = fbb_.GetSize();
+    bytes_sent_in_window_ += fbb_.GetSize();
+  }
+  ++tick_;
+  UpdateBandwidth(time);
+}
+
+void ReplicationSession::Encode(Peer* peer) {
+  // Encode against the newest snapshot the peer is known to have, if we still
+  // remember what was in it.
+  const ReplicationSnapshot* baseline = nullptr;
+  if (peer->acked_tick != 0 && tick_ - peer->acked_tick < kHistorySize) {
+    baseline = &peer->sent[peer->acked_tick % kHistorySize];
+  }
+
+  fbb_.Clear();
+  flatbuffers::Offset<RaftState> raft;
+  if (baseline == nullptr || !(local_.raft == baseline->raft)) {
+    raft = CreateRaftState(fbb_, local_.raft.lap_number,
+                           local_.raft.total_lap_progress,
+                           &local_.raft.position, &local_.raft.orientation);
+  }
+
+  std::vector<PatronUpdate> patrons;
+  for (size_t i = 0; i < local_.patrons.size(); ++i) {
+    const PatronSnapshot& patron = local_.patrons[i];
+    if (baseline == nullptr || i >= baseline->patrons.size() ||
+        !(patron == baseline->patrons[i])) {
+      patrons.push_back(PatronUpdate(static_cast<uint16_t>(i), patron.state,
+                                     patron.position, patron.orientation));
+    }
+  }
+  flatbuffers::Offset<flatbuffers::Vector<const PatronUpdate*>> patrons_offset;
+  if (!patrons.empty()) patrons_offset = fbb_.CreateVectorOfStructs(patrons);
+
+  std::vector<ProjectileSpawn> spawns;
+  for (auto it = pending_spawns_.begin(); it != pending_spawns_.end(); ++it) {
+    if (it->tick > peer->acked_tick) spawns.push_back(it->spawn);
+  }
+  flatbuffers::Offset<flatbuffers::Vector<const ProjectileSpawn*>>
+      spawns_offset;
+  if (!spawns.empty()) spawns_offset = fbb_.CreateVectorOfStructs(spawns);
+
+  ReplicationPacketBuilder builder(fbb_);
+  builder.add_tick(tick_);
+  builder.add_baseline_tick(baseline ? peer->acked_tick : 0);
+  builder.add_ack_tick(peer->latest_received_tick);
+  if (raft.o != 0) builder.add_raft(raft);
+  builder.add_patron_count(static_cast<uint16_t>(local_.patrons.size()));
+  if (patrons_offset.o != 0) builder.add_patrons(patrons_offset);
+  if (spawns_offset.o != 0) builder.add_spawns(spawns_offset);
+  FinishReplicationPacketBuffer(fbb_, builder.Finish());
+
+  peer->sent[tick_ % kHistorySize] = local_;
+}
+
+void ReplicationSession::ReceivePackets() {
+  int peer = 0;
+  std::vector<uint8_t> data;
+  while (transport_->Receive(&peer, &data)) {
+    bytes_received_in_window_ += static_cast<uint32_t>(data.size());
+    if (peer >= 0 && peer < static_cast<int>(peers_.size())) {
+      Decode(peer, data);
+    }
+  }
+  PrunePendingSpawns();
+}
+
+void ReplicationSession::Decode(int peer_index,
+                                const std::vector<uint8_t>& data) {
+  flatbuffers::Verifier verifier(data.data(), data.size());
+  if (!VerifyReplicationPacketBuffer(verifier)) return;
+  const ReplicationPacket* packet = GetReplicationPacket(data.data());
+  Peer& peer = peers_[peer_index];
+
+  if (packet->ack_tick() > peer.acked_tick && packet->ack_tick() < tick_) {
+    peer.acked_tick = packet->ack_tick();
+  }
+
+  // Every packet repeats the spawns we have not acknowledged, in order, so
+  // anything at or below the newest id already seen is a repeat.
+  auto spawns = packet->spawns();
+  for (flatbuffers::uoffset_t i = 0; spawns != nullptr && i < spawns->size();
+       ++i) {
+    const ProjectileSpawn* spawn = spawns->Get(i);
+    if (spawn->id() > peer.last_spawn_id) {
+      received_spawns_.push_back(std::make_pair(peer_index, *spawn));
+      peer.last_spawn_id = spawn->id();
+    }
+  }
+
+  // Ignore state older than what we already have.
+  const uint32_t tick = packet->tick();
+  if (tick <= peer.latest_received_tick) return;
+
+  ReplicationSnapshot& snapshot = peer.received[tick % kHistorySize];
+  const uint32_t baseline_tick = packet->baseline_tick();
+  if (baseline_tick != 0) {
+    const ReplicationSnapshot& baseline =
+        peer.received[baseline_tick % kHistorySize];
+    // We no longer have the baseline; wait for a packet we can decode.
+    if (baseline.tick != baseline_tick) return;
+    snapshot = baseline;
+  } else {
+    snapshot = ReplicationSnapshot();
+  }
+  snapshot.tick = tick;
+
+  const RaftState* raft = packet->raft();
+  if (raft != nullptr) {
+    snapshot.raft.lap_number = raft->lap_number();
+    snapshot.raft.total_lap_progress = raft->total_lap_progress();
+    if (raft->position()) snapshot.raft.position = *raft->position();
+    if (raft->orientation()) snapshot.raft.orientation = *raft->orientation();
+  }
+
+  snapshot.patrons.resize(packet->patron_count());
+  auto patrons = packet->patrons();
+  for (flatbuffers::uoffset_t i = 0; patrons != nullptr && i < patrons->size();
+       ++i) {
+    const PatronUpdate* update = patrons->Get(i);
+    if (update->index() >= snapshot.patrons.size()) continue;
+    PatronSnapshot& patron = snapshot.patrons[update->index()];
+    patron.state = update->state();
+    patron.position = update->position();
+    patron.orientation = update->orientation();
+  }
+
+  peer.latest_received_tick = tick;
+}
+
+void ReplicationSession::PrunePendingSpawns() {
+  if (pending_spawns_.empty()) return;
+  uint32_t acked_by_all = tick_;
+  for (auto it = peers_.begin(); it != peers_.end(); ++it) {
+    acked_by_all = std::min(acked_by_all, it->acked_tick);
+  }
+  pending_spawns_.erase(
+      std::remove_if(pending_spawns_.begin(), pending_spawns_.end(),
+                     [acked_by_all](const PendingSpawn& pending) {
+                       return pending.tick <= acked_by_all;
+                     }),
+      pending_spawns_.end());
+}
+
+void ReplicationSession::UpdateBandwidth(uint32_t time) {
+  const uint32_t elapsed = time - bandwidth_window_start_;
+  if (elapsed < 1000) return;
+  bytes_sent_per_second_ =
+      static_cast<uint32_t>(uint64_t(bytes_sent_in_window_) * 1000 / elapsed);
+  bytes_received_per_second_ = static_cast<uint32_t>(
+      uint64_t(bytes_received_in_window_) * 1000 / elapsed);
+  bytes_sent_in_window_ = 0;
+  bytes_received_in_window_ = 0;
+  bandwidth_window_start_ = time;
+}
+
+}  // zooshi
+}  // fpl
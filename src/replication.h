@@ -0,0 +1,208 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_REPLICATION_H_
+#define ZOOSHI_REPLICATION_H_
+
+#include <stdint.h>
+#include <deque>
+#include <vector>
+
+#include "mathfu/glsl_mappings.h"
+#include "replication_generated.h"
+
+namespace fpl {
+namespace zooshi {
+
+// Positions are replicated to the nearest 1/16 unit, which covers +/-2048
+// units, and velocities to the nearest 1/64 unit per second.
+const float kReplicatedPositionScale = 16.0f;
+const float kReplicatedVelocityScale = 64.0f;
+
+QuantizedVec3 QuantizeVec3(const mathfu::vec3& v, float scale);
+mathfu::vec3 DequantizeVec3(const QuantizedVec3& q, float scale);
+QuantizedQuat QuantizeQuat(const mathfu::quat& q);
+mathfu::quat DequantizeQuat(const QuantizedQuat& q);
+
+bool operator==(const QuantizedVec3& a, const QuantizedVec3& b);
+bool operator==(const QuantizedQuat& a, const QuantizedQuat& b);
+
+// The replicated game state. Everything is kept quantized, so that deciding
+// what has changed since a baseline is an exact comparison.
+struct RaftSnapshot {
+  RaftSnapshot() : lap_number(0), total_lap_progress(0.0f) {}
+  bool operator==(const RaftSnapshot& other) const;
+
+  int32_t lap_number;
+  float total_lap_progress;
+  QuantizedVec3 position;
+  QuantizedQuat orientation;
+};
+
+struct PatronSnapshot {
+  PatronSnapshot() : state(0) {}
+  bool operator==(const PatronSnapshot& other) const;
+
+  uint8_t state;
+  QuantizedVec3 position;
+  QuantizedQuat orientation;
+};
+
+struct ReplicationSnapshot {
+  ReplicationSnapshot() : tick(0) {}
+
+  // 0 if the snapshot holds nothing yet.
+  uint32_t tick;
+  RaftSnapshot raft;
+  std::vector<PatronSnapshot> patrons;
+};
+
+// Moves packets between the players in a session. Packets may be dropped or
+// arrive out of order; they are never partially delivered.
+class ReplicationTransport {
+ public:
+  virtual ~ReplicationTransport() {}
+
+  // Peers are numbered from 0.
+  virtual int peer_count() const = 0;
+  virtual void Send(int peer, const uint8_t* data, size_t size) = 0;
+  // Fetch the next packet received from any peer. Returns false if there are
+  // none.
+  virtual bool Receive(int* peer, std::vector<uint8_t>* data) = 0;
+};
+
+// An in-process transport that connects two sessions directly, dropping a
+// given fraction of packets. Used to exercise replication without a network.
+class LoopbackReplicationTransport : public ReplicationTransport {
+ public:
+  LoopbackReplicationTransport()
+      : other_(nullptr), loss_rate_(0.0f), random_state_(1) {}
+
+  // Connect `a` and `b` to each other, as each other's peer 0.
+  static void Connect(LoopbackReplicationTransport* a,
+                      LoopbackReplicationTransport* b);
+
+  // The fraction of packets sent from this end that are dropped.
+  void set_loss_rate(float loss_rate) { loss_rate_ = loss_rate; }
+
+  virtual int peer_count() const { return other_ ? 1 : 0; }
+  virtual void Send(int peer, const uint8_t* data, size_t size);
+  virtual bool Receive(int* peer, std::vector<uint8_t>* data);
+
+ private:
+  LoopbackReplicationTransport* other_;
+  std::deque<std::vector<uint8_t>> inbox_;
+  float loss_rate_;
+  // A fixed-seed generator, so that runs are repeatable.
+  uint32_t random_state_;
+};
+
+// Replicates the local player's game state to every peer on a transport, and
+// reconstructs each peer's state from what it sends.
+//
+// Once per tick, Tick() sends each peer a single packet holding the local
+// snapshot, delta-encoded against the newest snapshot that peer has
+// acknowledged, plus every projectile spawn it has not yet acknowledged.
+// Acknowledgements ride along on the packets going the other way, so both
+// ends must call Tick() regularly.
+class ReplicationSession {
+ public:
+  explicit ReplicationSession(ReplicationTransport* transport);
+
+  // The state to send on the next Tick(). Fill it in each tick.
+  ReplicationSnapshot* local_snapshot() { return &local_; }
+
+  // Queue a projectile spawn to send to every peer. Its id is assigned here.
+  void AddProjectileSpawn(const ProjectileSpawn& spawn);
+
+  // Encode and send this tick's packet to each peer. `time` is in
+  // milliseconds and is only used to measure bandwidth.
+  void Tick(uint32_t time);
+
+  // Decode every packet that has arrived, updating each peer's state and
+  // collecting the projectiles it spawned.
+  void ReceivePackets();
+
+  // The newest state decoded from `peer`. Its tick is 0 until the first
+  // packet arrives.
+  const ReplicationSnapshot& peer_snapshot(int peer) const {
+    return peers_[peer].received[peers_[peer].latest_received_tick %
+                                 kHistorySize];
+  }
+
+  // Projectiles spawned by peers since this was last cleared, in the order
+  // they were spawned, along with the peer that spawned each.
+  std::vector<std::pair<int, ProjectileSpawn>>* received_spawns() {
+    return &received_spawns_;
+  }
+
+  // Bytes per second sent and received over the last whole second.
+  uint32_t bytes_sent_per_second() const { return bytes_sent_per_second_; }
+  uint32_t bytes_received_per_second() const {
+    return bytes_received_per_second_;
+  }
+  // The size of the last packet sent, in bytes.
+  size_t last_packet_size() const { return last_packet_size_; }
+
+ private:
+  // Snapshots older than this many ticks cannot be used as baselines.
+  static const uint32_t kHistorySize = 32;
+
+  struct Peer {
+    Peer() : acked_tick(0), latest_received_tick(0), last_spawn_id(0) {}
+
+    // What was sent to the peer, indexed by tick % kHistorySize.
+    ReplicationSnapshot sent[kHistorySize];
+    // What was decoded from the peer, indexed the same way.
+    ReplicationSnapshot received[kHistorySize];
+    // The newest of our ticks the peer has acknowledged.
+    uint32_t acked_tick;
+    // The newest of the peer's ticks we have decoded.
+    uint32_t latest_received_tick;
+    // The id of the newest projectile spawn received from the peer.
+    uint32_t last_spawn_id;
+  };
+
+  struct PendingSpawn {
+    uint32_t tick;
+    ProjectileSpawn spawn;
+  };
+
+  void Encode(Peer* peer);
+  void Decode(int peer_index, const std::vector<uint8_t>& data);
+  // Forget spawns every peer has acknowledged.
+  void PrunePendingSpawns();
+  void UpdateBandwidth(uint32_t time);
+
+  ReplicationTransport* transport_;
+  std::vector<Peer> peers_;
+  ReplicationSnapshot local_;
+  uint32_t tick_;
+  uint32_t next_spawn_id_;
+  std::vector<PendingSpawn> pending_spawns_;
+  std::vector<std::pair<int, ProjectileSpawn>> received_spawns_;
+  flatbuffers::FlatBufferBuilder fbb_;
+
+  uint32_t bandwidth_window_start_;
+  uint32_t bytes_sent_in_window_;
+  uint32_t bytes_received_in_window_;
+  uint32_t bytes_sent_per_second_;
+  uint32_t bytes_received_per_second_;
+  size_t last_packet_size_;
+};
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_REPLICATION_H_
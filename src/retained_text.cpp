@@ -0,0 +1,116 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "retained_text.h"
+
+namespace fpl {
+namespace zooshi {
+
+// Chunks are at least this many lines of the source text.
+static const int kMinChunkLines = 16;
+
+// Chunks this close to the viewport are laid out too, so that they are ready
+// before they scroll into view.
+static const float kViewportMargin = 100.0f;
+
+void RetainedText::SetText(const std::string& text) {
+  if (text == text_) return;
+  text_ = text;
+  chunks_.clear();
+
+  // Only break at single line breaks: splitting there lays out exactly as
+  // the whole text would, since each label starts on a new line anyway.
+  size_t begin = 0;
+  int lines = 0;
+  for (size_t i = 0; i < text_.size(); ++i) {
+    if (text_[i] != '\n') continue;
+    ++lines;
+    const bool single = (i == 0 || text_[i - 1] != '\n') &&
+                        (i + 1 == text_.size() || text_[i + 1] != '\n');
+    if (lines >= kMinChunkLines && single && i + 1 < text_.size()) {
+      Chunk chunk = {text_.substr(begin, i - begin), -1.0f};
+      chunks_.push_back(chunk);
+      begin = i + 1;
+      lines = 0;
+    }
+  }
+  Chunk chunk = {text_.substr(begin), -1.0f};
+  chunks_.push_back(chunk);
+}
+
+void RetainedText::Invalidate() {
+  for (auto it = chunks_.begin(); it != chunks_.end(); ++it) {
+    it->height = -1.0f;
+  }
+}
+
+void RetainedText::Spacer(const char* id, float width, float height) {
+  if (height <= 0.0f) return;
+  flatui::CustomElement(mathfu::vec2(width, height), id,
+                        [](const mathfu::vec2i& /*pos*/,
+                           const mathfu::vec2i& /*size*/) {});
+}
+
+mathfu::vec2 RetainedText::Label(float ysize, float width,
+                                 flatui::TextAlignment alignment,
+                                 bool hyphenate,
+                                 const mathfu::vec2& scroll_offset,
+                                 float viewport_height) {
+  const mathfu::vec2 virtual_resolution = flatui::GetVirtualResolution();
+  if (ysize != ysize_ || width != width_ || hyphenate != hyphenate_ ||
+      virtual_resolution.x != virtual_resolution_.x ||
+      virtual_resolution.y != virtual_resolution_.y) {
+    ysize_ = ysize;
+    width_ = width;
+    hyphenate_ = hyphenate;
+    virtual_resolution_ = virtual_resolution;
+    Invalidate();
+  }
+
+  const float view_top = scroll_offset.y - kViewportMargin;
+  const float view_bottom = scroll_offset.y + viewport_height + kViewportMargin;
+
+  flatui::StartGroup(flatui::kLayoutVerticalLeft, 0);
+  flatui::EnableTextHyphenation(hyphenate);
+  float top = 0.0f;
+  float skipped = 0.0f;
+  bool emitted = false;
+  for (auto it = chunks_.begin(); it != chunks_.end(); ++it) {
+    const bool measured = it->height >= 0.0f;
+    const bool visible = !measured || (top + it->height >= view_top &&
+                                       top <= view_bottom);
+    if (visible) {
+      Spacer(emitted ? "retained_text_gap" : "retained_text_above", width,
+             skipped);
+      skipped = 0.0f;
+      emitted = true;
+      flatui::StartGroup(flatui::kLayoutVerticalLeft, 0);
+      flatui::Label(it->text.c_str(), ysize, mathfu::vec2(width, 0),
+                    alignment);
+      it->height = flatui::GroupSize().y;
+      flatui::EndGroup();
+    } else {
+      skipped += it->height;
+    }
+    top += it->height;
+  }
+  Spacer("retained_text_below", width, skipped);
+  if (hyphenate) flatui::EnableTextHyphenation(false);
+  flatui::EndGroup();
+
+  return mathfu::vec2(width, top);
+}
+
+}  // zooshi
+}  // fpl
@@ -0,0 +1,79 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_RETAINED_TEXT_H_
+#define ZOOSHI_RETAINED_TEXT_H_
+
+#include <string>
+#include <vector>
+
+#include "flatui/flatui.h"
+#include "mathfu/glsl_mappings.h"
+
+namespace fpl {
+namespace zooshi {
+
+// A long, static block of text shown in a flatui scroll area, such as the
+// about or license screens.
+//
+// Laying out the whole text every frame is expensive, and nearly all of it is
+// scrolled out of view. Instead the text is split into chunks at line breaks
+// when it is set, and the layout height of each chunk is retained from the
+// frames it was visible in. Each frame only the chunks that overlap the
+// viewport are emitted as labels, so flatui only lays out and draws those;
+// everything above and below them is replaced by an empty element of the
+// retained height. The retained heights are dropped whenever anything that
+// affects the layout changes.
+class RetainedText {
+ public:
+  RetainedText() : ysize_(0.0f), width_(0.0f), hyphenate_(false) {}
+
+  // Use `text` from now on. Does nothing if the text has not changed.
+  void SetText(const std::string& text);
+
+  // Emit the text, `width` wide and with lines `ysize` high. Call this
+  // between flatui::StartScroll() and flatui::EndScroll(), passing the same
+  // scroll offset and the height of the scroll area. Returns the size of the
+  // whole text, for sizing the scroll bar.
+  mathfu::vec2 Label(float ysize, float width,
+                     flatui::TextAlignment alignment, bool hyphenate,
+                     const mathfu::vec2& scroll_offset, float viewport_height);
+
+  // Forget the retained layout, so that every chunk is laid out again.
+  void Invalidate();
+
+ private:
+  struct Chunk {
+    std::string text;
+    // The height of the chunk when it was last laid out, or negative if it
+    // has not been laid out since the last Invalidate().
+    float height;
+  };
+
+  // Emit an empty element standing in for chunks that are out of view.
+  static void Spacer(const char* id, float width, float height);
+
+  std::string text_;
+  std::vector<Chunk> chunks_;
+  // The parameters the retained heights were laid out with.
+  float ysize_;
+  float width_;
+  bool hyphenate_;
+  mathfu::vec2 virtual_resolution_;
+};
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_RETAINED_TEXT_H_
@@ -0,0 +1,403 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "save_manager.h"
+
+#include <stdio.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif  // _WIN32
+
+#include "fplbase/utilities.h"
+#include "save_data_generated.h"
+
+namespace fpl {
+namespace zooshi {
+
+// How long to wait after the first change before writing, so that a burst of
+// changes (e.g. dragging a volume slider) is written out once.
+static const uint32_t kCoalesceTime = 1000;
+
+SaveManager::SaveManager()
+    : mutex_(SDL_CreateMutex()),
+      wake_writer_(SDL_CreateCond()),
+      writer_thread_(nullptr),
+      current_xp_(0),
+      has_progress_(false),
+      has_settings_(false),
+      has_remote_config_(false),
+      dirty_(false),
+      dirty_time_(0),
+      flush_requested_(false),
+      exiting_(false) {}
+
+SaveManager::~SaveManager() {
+  Shutdown();
+  SDL_DestroyCond(wake_writer_);
+  SDL_DestroyMutex(mutex_);
+}
+
+void SaveManager::Initialize(const char* app_name) {
+  std::string storage_path;
+  if (!fplbase::GetStoragePath(app_name, &storage_path)) {
+    fplbase::LogError("Unable to find storage path, nothing will be saved.");
+    return;
+  }
+  save_path_ = storage_path + kSaveFileName;
+  temp_path_ = save_path_ + ".tmp";
+
+  SDL_LockMutex(mutex_);
+  std::string data;
+  if (fplbase::LoadPreferences(temp_path_.c_str(), &data) && Read(data)) {
+    // The last write finished but the game died before renaming it into
+    // place. It is newer than the save file, so finish the job.
+    fplbase::LogInfo("Recovered save data from %s", temp_path_.c_str());
+    MarkDirty();
+    flush_requested_ = true;
+  } else if (fplbase::LoadPreferences(save_path_.c_str(), &data) &&
+             !Read(data)) {
+    fplbase::LogError("Ignoring invalid save data in %s", save_path_.c_str());
+  }
+  SDL_UnlockMutex(mutex_);
+
+  writer_thread_ = SDL_CreateThread(WriterThread, "Zooshi Save Thread", this);
+}
+
+void SaveManager::Flush() {
+  SDL_LockMutex(mutex_);
+  flush_requested_ = true;
+  SDL_CondSignal(wake_writer_);
+  SDL_UnlockMutex(mutex_);
+}
+
+void SaveManager::Shutdown() {
+  if (writer_thread_ == nullptr) return;
+  SDL_LockMutex(mutex_);
+  exiting_ = true;
+  SDL_CondSignal(wake_writer_);
+  SDL_UnlockMutex(mutex_);
+  SDL_WaitThread(writer_thread_, nullptr);
+  writer_thread_ = nullptr;
+}
+
+bool SaveManager::has_progress() const {
+  SDL_LockMutex(mutex_);
+  const bool has_progress = has_progress_;
+  SDL_UnlockMutex(mutex_);
+  return has_progress;
+}
+
+int SaveManager::current_xp() const {
+  SDL_LockMutex(mutex_);
+  const int current_xp = current_xp_;
+  SDL_UnlockMutex(mutex_);
+  return current_xp;
+}
+
+void SaveManager::set_current_xp(int current_xp) {
+  SDL_LockMutex(mutex_);
+  if (current_xp_ != current_xp) {
+    current_xp_ = current_xp;
+    MarkDirty();
+  }
+  SDL_UnlockMutex(mutex_);
+}
+
+bool SaveManager::IsUnlocked(UnlockableType type, size_t index) const {
+  SDL_LockMutex(mutex_);
+  const std::vector<bool>& unlocked = unlocked_[type];
+  const bool is_unlocked = index < unlocked.size() && unlocked[index];
+  SDL_UnlockMutex(mutex_);
+  return is_unlocked;
+}
+
+void SaveManager::SetUnlocked(UnlockableType type, size_t index,
+                              bool unlocked) {
+  SDL_LockMutex(mutex_);
+  std::vector<bool>& bits = unlocked_[type];
+  if (index >= bits.size()) bits.resize(index + 1, false);
+  if (bits[index] != unlocked) {
+    bits[index] = unlocked;
+    MarkDirty();
+  }
+  SDL_UnlockMutex(mutex_);
+}
+
+bool SaveManager::has_settings() const {
+  SDL_LockMutex(mutex_);
+  const bool has_settings = has_settings_;
+  SDL_UnlockMutex(mutex_);
+  return has_settings;
+}
+
+SaveSettings SaveManager::settings() const {
+  SDL_LockMutex(mutex_);
+  const SaveSettings settings = settings_;
+  SDL_UnlockMutex(mutex_);
+  return settings;
+}
+
+void SaveManager::set_settings(const SaveSettings& settings) {
+  SDL_LockMutex(mutex_);
+  settings_ = settings;
+  has_settings_ = true;
+  MarkDirty();
+  SDL_UnlockMutex(mutex_);
+}
+
+bool SaveManager::has_remote_config() const {
+  SDL_LockMutex(mutex_);
+  const bool has_remote_config = has_remote_config_;
+  SDL_UnlockMutex(mutex_);
+  return has_remote_config;
+}
+
+SaveRemoteConfig SaveManager::remote_config() const {
+  SDL_LockMutex(mutex_);
+  const SaveRemoteConfig remote_config = remote_config_;
+  SDL_UnlockMutex(mutex_);
+  return remote_config;
+}
+
+void SaveManager::set_remote_config(const SaveRemoteConfig& remote_config) {
+  SDL_LockMutex(mutex_);
+  remote_config_ = remote_config;
+  has_remote_config_ = true;
+  MarkDirty();
+  SDL_UnlockMutex(mutex_);
+}
+
+SaveHighScore SaveManager::high_score(
+    const std::string& leaderboard_id) const {
+  SDL_LockMutex(mutex_);
+  auto it = high_scores_.find(leaderboard_id);
+  const SaveHighScore high_score =
+      it != high_scores_.end() ? it->second : SaveHighScore();
+  SDL_UnlockMutex(mutex_);
+  return high_score;
+}
+
+void SaveManager::set_high_score(const std::string& leaderboard_id,
+                                 const SaveHighScore& high_score) {
+  SDL_LockMutex(mutex_);
+  SaveHighScore& saved = high_scores_[leaderboard_id];
+  if (saved.score != high_score.score ||
+      saved.unconfirmed != high_score.unconfirmed) {
+    saved = high_score;
+    MarkDirty();
+  }
+  SDL_UnlockMutex(mutex_);
+}
+
+int SaveManager::WriterThread(void* data) {
+  static_cast<SaveManager*>(data)->WriterLoop();
+  return 0;
+}
+
+void SaveManager::WriterLoop() {
+  SDL_LockMutex(mutex_);
+  for (;;) {
+    if (!dirty_) {
+      if (exiting_) break;
+      SDL_CondWait(wake_writer_, mutex_);
+      continue;
+    }
+    // Give further changes a chance to arrive, unless asked to hurry.
+    const uint32_t waited = SDL_GetTicks() - dirty_time_;
+    if (!flush_requested_ && !exiting_ && waited < kCoalesceTime) {
+      SDL_CondWaitTimeout(wake_writer_, mutex_, kCoalesceTime - waited);
+      continue;
+    }
+    std::string data;
+    Serialize(&data);
+    dirty_ = false;
+    flush_requested_ = false;
+
+    // Changes made while writing will be picked up on the next pass.
+    SDL_UnlockMutex(mutex_);
+    Write(data);
+    SDL_LockMutex(mutex_);
+  }
+  SDL_UnlockMutex(mutex_);
+}
+
+bool SaveManager::Read(const std::string& data) {
+  flatbuffers::Verifier verifier(reinterpret_cast<const uint8_t*>(data.c_str()),
+                                 data.size());
+  if (!VerifySaveDataBuffer(verifier)) return false;
+
+  const SaveData* save_data = GetSaveData(data.c_str());
+  has_settings_ = save_data->has_settings();
+  if (has_settings_) {
+    settings_.effect_volume = save_data->effect_volume();
+    settings_.music_volume = save_data->music_volume();
+    settings_.render_shadows = save_data->render_shadows();
+    settings_.apply_phong = save_data->apply_phong();
+    settings_.apply_specular = save_data->apply_specular();
+    settings_.render_shadows_cardboard = save_data->render_shadows_cardboard();
+    settings_.apply_phong_cardboard = save_data->apply_phong_cardboard();
+    settings_.apply_specular_cardboard = save_data->apply_specular_cardboard();
+    settings_.gyroscopic_controls_enabled =
+        save_data->gyroscopic_controls_enabled() != 0;
+  }
+
+  const ProgressSaveData* progress = save_data->progress();
+  has_progress_ = progress != nullptr;
+  if (progress != nullptr) {
+    current_xp_ = progress->current_xp();
+    auto unlockables = progress->unlockables();
+    for (flatbuffers::uoffset_t i = 0;
+         unlockables != nullptr && i < unlockables->size(); ++i) {
+      const UnlockableSaveData* unlockable = unlockables->Get(i);
+      const int type = unlockable->type();
+      auto bits = unlockable->bits();
+      if (type < 0 || type >= UnlockableType_Size || bits == nullptr) continue;
+      std::vector<bool>& unlocked = unlocked_[type];
+      unlocked.resize(bits->size() * 8);
+      for (size_t j = 0; j < unlocked.size(); ++j) {
+        unlocked[j] = (bits->Get(static_cast<flatbuffers::uoffset_t>(j / 8)) &
+                       (1 << (j % 8))) != 0;
+      }
+    }
+  }
+
+  const RemoteConfigSaveData* remote_config = save_data->remote_config();
+  has_remote_config_ = remote_config != nullptr;
+  if (remote_config != nullptr) {
+    remote_config_.rewarded_video_location =
+        remote_config->rewarded_video_location();
+    if (remote_config->menu_play_game()) {
+      remote_config_.menu_play_game = remote_config->menu_play_game()->str();
+    }
+    if (remote_config->menu_send_invite()) {
+      remote_config_.menu_send_invite =
+          remote_config->menu_send_invite()->str();
+    }
+    if (remote_config->menu_offer_video()) {
+      remote_config_.menu_offer_video =
+          remote_config->menu_offer_video()->str();
+    }
+  }
+
+  auto high_scores = save_data->high_scores();
+  for (flatbuffers::uoffset_t i = 0;
+       high_scores != nullptr && i < high_scores->size(); ++i) {
+    const HighScoreSaveData* saved = high_scores->Get(i);
+    if (saved->leaderboard_id() == nullptr) continue;
+    SaveHighScore& high_score = high_scores_[saved->leaderboard_id()->str()];
+    high_score.score = saved->score();
+    high_score.unconfirmed = saved->unconfirmed();
+  }
+  return true;
+}
+
+void SaveManager::Serialize(std::string* data) const {
+  flatbuffers::FlatBufferBuilder fbb;
+
+  std::vector<flatbuffers::Offset<UnlockableSaveData>> unlockables;
+  for (int type = 0; type < UnlockableType_Size; ++type) {
+    const std::vector<bool>& unlocked = unlocked_[type];
+    std::vector<uint8_t> bits((unlocked.size() + 7) / 8, 0);
+    for (size_t j = 0; j < unlocked.size(); ++j) {
+      if (unlocked[j]) bits[j / 8] |= static_cast<uint8_t>(1 << (j % 8));
+    }
+    unlockables.push_back(CreateUnlockableSaveData(
+        fbb, static_cast<int8_t>(type), fbb.CreateVector(bits)));
+  }
+  auto progress = CreateProgressSaveData(fbb, current_xp_,
+                                         fbb.CreateVector(unlockables));
+
+  flatbuffers::Offset<RemoteConfigSaveData> remote_config = 0;
+  if (has_remote_config_) {
+    remote_config = CreateRemoteConfigSaveData(
+        fbb, remote_config_.rewarded_video_location,
+        fbb.CreateString(remote_config_.menu_play_game),
+        fbb.CreateString(remote_config_.menu_send_invite),
+        fbb.CreateString(remote_config_.menu_offer_video));
+  }
+
+  std::vector<flatbuffers::Offset<HighScoreSaveData>> high_scores;
+  for (auto it = high_scores_.begin(); it != high_scores_.end(); ++it) {
+    high_scores.push_back(CreateHighScoreSaveData(
+        fbb, fbb.CreateString(it->first), it->second.score,
+        it->second.unconfirmed));
+  }
+  auto high_scores_vector = fbb.CreateVector(high_scores);
+
+  SaveDataBuilder builder(fbb);
+  builder.add_effect_volume(settings_.effect_volume);
+  builder.add_music_volume(settings_.music_volume);
+  builder.add_render_shadows(settings_.render_shadows);
+  builder.add_apply_phong(settings_.apply_phong);
+  builder.add_apply_specular(settings_.apply_specular);
+  builder.add_render_shadows_cardboard(settings_.render_shadows_cardboard);
+  builder.add_apply_phong_cardboard(settings_.apply_phong_cardboard);
+  builder.add_apply_specular_cardboard(settings_.apply_specular_cardboard);
+  builder.add_gyroscopic_controls_enabled(
+      settings_.gyroscopic_controls_enabled ? 1 : 0);
+  builder.add_has_settings(has_settings_);
+  builder.add_progress(progress);
+  if (has_remote_config_) builder.add_remote_config(remote_config);
+  builder.add_high_scores(high_scores_vector);
+  FinishSaveDataBuffer(fbb, builder.Finish());
+
+  data->assign(reinterpret_cast<const char*>(fbb.GetBufferPointer()),
+               fbb.GetSize());
+}
+
+// Write `data` to `filename` and make sure it has reached the disk before
+// returning, so that renaming the file afterwards can't leave a truncated save
+// behind if the device loses power.
+static bool WriteFileDurably(const char* filename, const std::string& data) {
+  FILE* file = fopen(filename, "wb");
+  if (!file) return false;
+  bool ok = fwrite(data.c_str(), 1, data.size(), file) == data.size() &&
+            fflush(file) == 0;
+#ifdef _WIN32
+  ok = ok && _commit(_fileno(file)) == 0;
+#else
+  ok = ok && fsync(fileno(file)) == 0;
+#endif  // _WIN32
+  return fclose(file) == 0 && ok;
+}
+
+bool SaveManager::Write(const std::string& data) const {
+  if (!WriteFileDurably(temp_path_.c_str(), data)) {
+    fplbase::LogError("Unable to write save data to %s", temp_path_.c_str());
+    return false;
+  }
+#ifdef _WIN32
+  // rename() will not replace an existing file on Windows. If the game dies
+  // between these two calls, the temporary file is recovered on next load.
+  remove(save_path_.c_str());
+#endif  // _WIN32
+  if (rename(temp_path_.c_str(), save_path_.c_str()) != 0) {
+    fplbase::LogError("Unable to move save data to %s", save_path_.c_str());
+    return false;
+  }
+  return true;
+}
+
+void SaveManager::MarkDirty() {
+  if (!dirty_) {
+    dirty_ = true;
+    dirty_time_ = SDL_GetTicks();
+    SDL_CondSignal(wake_writer_);
+  }
+}
+
+}  // zooshi
+}  // fpl
@@ -0,0 +1,170 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_SAVE_MANAGER_H_
+#define ZOOSHI_SAVE_MANAGER_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "SDL_thread.h"
+#include "unlockables_generated.h"
+
+namespace fpl {
+namespace zooshi {
+
+const auto kSaveFileName = "save_data.zoosave";
+const auto kSaveAppName = "zooshi";
+
+// The user's settings, as stored in the save file.
+struct SaveSettings {
+  SaveSettings()
+      : effect_volume(1.0f),
+        music_volume(1.0f),
+        render_shadows(false),
+        apply_phong(false),
+        apply_specular(false),
+        render_shadows_cardboard(false),
+        apply_phong_cardboard(false),
+        apply_specular_cardboard(false),
+        gyroscopic_controls_enabled(true) {}
+
+  float effect_volume;
+  float music_volume;
+  bool render_shadows;
+  bool apply_phong;
+  bool apply_specular;
+  bool render_shadows_cardboard;
+  bool apply_phong_cardboard;
+  bool apply_specular_cardboard;
+  bool gyroscopic_controls_enabled;
+};
+
+// The remote config values last activated, as stored in the save file.
+struct SaveRemoteConfig {
+  SaveRemoteConfig() : rewarded_video_location(0) {}
+
+  int64_t rewarded_video_location;
+  std::string menu_play_game;
+  std::string menu_send_invite;
+  std::string menu_offer_video;
+};
+
+// The best score on one leaderboard, as stored in the save file.
+struct SaveHighScore {
+  SaveHighScore() : score(0), unconfirmed(false) {}
+
+  int64_t score;
+  // True until the leaderboard server has been seen to hold `score`.
+  bool unconfirmed;
+};
+
+// Owns everything the game persists: XP, unlocks, settings, high scores and
+// the last remote config, all kept in one SaveData flatbuffer. The file is
+// read once by Initialize(). Changes are made in memory and coalesced; a
+// background thread serializes and writes them out a short while after the
+// first change, so no caller ever waits on storage.
+//
+// Writes go to a temporary file which is then renamed over the save file. If
+// the game dies part way through, the old save file is still intact, and a
+// temporary file that was completely written but not yet renamed is picked up
+// on the next load.
+//
+// All methods are thread safe.
+class SaveManager {
+ public:
+  SaveManager();
+  ~SaveManager();
+
+  // Load the save file for `app_name` and start the writer thread.
+  void Initialize(const char* app_name);
+
+  // Write any pending changes now rather than waiting for more to coalesce.
+  // Does not block. Call when the app may be about to be killed, e.g. when it
+  // goes into the background.
+  void Flush();
+
+  // Write any pending changes, then stop the writer thread.
+  void Shutdown();
+
+  // False if the save file had no progress in it, either because there was
+  // no file or because it was written by an older version. The XP and unlock
+  // state should then be migrated from wherever it used to be kept.
+  bool has_progress() const;
+
+  int current_xp() const;
+  void set_current_xp(int current_xp);
+
+  bool IsUnlocked(UnlockableType type, size_t index) const;
+  void SetUnlocked(UnlockableType type, size_t index, bool unlocked);
+
+  // False if no settings have been saved yet, in which case settings() holds
+  // the defaults.
+  bool has_settings() const;
+  SaveSettings settings() const;
+  void set_settings(const SaveSettings& settings);
+
+  // False if no remote config has been activated yet.
+  bool has_remote_config() const;
+  SaveRemoteConfig remote_config() const;
+  void set_remote_config(const SaveRemoteConfig& remote_config);
+
+  // The best score saved for `leaderboard_id`, or a zero score if none is.
+  SaveHighScore high_score(const std::string& leaderboard_id) const;
+  void set_high_score(const std::string& leaderboard_id,
+                      const SaveHighScore& high_score);
+
+ private:
+  static int WriterThread(void* data);
+  void WriterLoop();
+
+  // Parse a SaveData buffer. Returns false if it is not a valid save file.
+  bool Read(const std::string& data);
+  // Serialize the current state. Must be called with mutex_ held.
+  void Serialize(std::string* data) const;
+  // Write `data` to the temporary file and rename it over the save file.
+  bool Write(const std::string& data) const;
+  // Note that the state has changed. Must be called with mutex_ held.
+  void MarkDirty();
+
+  SDL_mutex* mutex_;
+  SDL_cond* wake_writer_;
+  SDL_Thread* writer_thread_;
+
+  std::string save_path_;
+  std::string temp_path_;
+
+  int current_xp_;
+  std::vector<bool> unlocked_[UnlockableType_Size];
+  SaveSettings settings_;
+  SaveRemoteConfig remote_config_;
+  std::map<std::string, SaveHighScore> high_scores_;
+  bool has_progress_;
+  bool has_settings_;
+  bool has_remote_config_;
+
+  // Set by changes, cleared once they have been handed to the writer.
+  bool dirty_;
+  // SDL_GetTicks() when dirty_ was last set from clean.
+  uint32_t dirty_time_;
+  bool flush_requested_;
+  bool exiting_;
+};
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_SAVE_MANAGER_H_
@@ -0,0 +1,86 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_SPSC_QUEUE_H_
+#define ZOOSHI_SPSC_QUEUE_H_
+
+#include <stddef.h>
+#include <atomic>
+
+namespace fpl {
+namespace zooshi {
+
+// A fixed-size, lock-free queue with exactly one producer thread and one
+// consumer thread. Push() must only be called by the producer and Pop() only
+// by the consumer. kCapacity must be a power of two; the queue holds at most
+// kCapacity elements, and Push() fails rather than blocking when it is full.
+template <typename T, size_t kCapacity>
+class SpscQueue {
+  static_assert(kCapacity != 0 && (kCapacity & (kCapacity - 1)) == 0,
+                "SpscQueue capacity must be a power of two");
+
+ public:
+  SpscQueue() : head_(0), tail_(0) {}
+
+  // Producer side. Returns false, dropping `value`, if the queue is full.
+  bool Push(const T& value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == kCapacity) {
+      return false;
+    }
+    elements_[tail & (kCapacity - 1)] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns false if the queue is empty.
+  bool Pop(T* value) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) return false;
+    *value = elements_[head & (kCapacity - 1)];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Discard everything currently in the queue.
+  void Clear() {
+    head_.store(tail_.load(std::memory_order_acquire),
+                std::memory_order_release);
+  }
+
+  // Approximate when called from a thread other than the producer or
+  // consumer.
+  size_t size() const {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+  static size_t capacity() { return kCapacity; }
+
+ private:
+  // Not copyable.
+  SpscQueue(const SpscQueue&);
+  SpscQueue& operator=(const SpscQueue&);
+
+  T elements_[kCapacity];
+  // Keep the two indices on separate cache lines so the producer and
+  // consumer do not contend.
+  alignas(64) std::atomic<size_t> head_;
+  alignas(64) std::atomic<size_t> tail_;
+};
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_SPSC_QUEUE_H_
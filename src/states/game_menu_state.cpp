@@ -33,7 +33,6 @@
 #include "motive/init.h"
 #include "motive/math/angle.h"
 #include "rail_def_generated.h"
-#include "save_data_generated.h"
 #include "states/states.h"
 #include "states/states_common.h"
 #include "world.h"
@@ -106,11 +105,16 @@ void GameMenuState::Initialize(
       asset_manager_->LoadTexture("textures/ui_button_unchecked.webp");
   cardboard_logo_ = asset_manager_->LoadTexture("textures/cardboard_logo.webp");
 
-  if (!fplbase::LoadFile(manifest->about_file()->c_str(), &about_text_)) {
+  std::string text;
+  if (fplbase::LoadFile(manifest->about_file()->c_str(), &text)) {
+    about_text_.SetText(text);
+  } else {
     fplbase::LogError("About text not found.");
   }
 
-  if (!fplbase::LoadFile(manifest->license_file()->c_str(), &license_text_)) {
+  if (fplbase::LoadFile(manifest->license_file()->c_str(), &text)) {
+    license_text_.SetText(text);
+  } else {
     fplbase::LogError("License text not found.");
   }
 
@@ -329,13 +333,11 @@ void GameMenuState::OnEnter(int previous_state) {
   // world.
   if (previous_state == kGameStateGameOver) {
     menu_state_ = kMenuStateScoreReview;
-    auto attribute_data =
-        world_->entity_manager.GetComponentData<AttributesData>(
-            world_->active_player_entity);
-    patrons_fed_ = static_cast<int>(
-        attribute_data->attributes[AttributeDef_PatronsFed]);
-    sushi_thrown_ = static_cast<int>(
-        attribute_data->attributes[AttributeDef_ProjectilesFired]);
+    const AttributesComponent &attributes = world_->attributes_component;
+    patrons_fed_ = static_cast<int>(attributes.GetAttribute(
+        world_->active_player_entity, AttributeDef_PatronsFed));
+    sushi_thrown_ = static_cast<int>(attributes.GetAttribute(
+        world_->active_player_entity, AttributeDef_ProjectilesFired));
     corgi::EntityRef raft =
         world_->entity_manager.GetComponent<ServicesComponent>()->raft_entity();
     RailDenizenData *raft_rail_denizen =
@@ -390,67 +392,52 @@ void GameMenuState::LoadData() {
   slider_value_effect_ = kEffectVolumeDefault;
   slider_value_music_ = kMusicVolumeDefault;
 
-  // Retrieve save file path.
-  std::string storage_path;
-  std::string data;
-  auto ret = fplbase::GetStoragePath(kSaveAppName, &storage_path);
-  if (ret &&
-      fplbase::LoadPreferences((storage_path + kSaveFileName).c_str(), &data)) {
-    auto save_data = GetSaveData(static_cast<const void *>(data.c_str()));
-    slider_value_effect_ = save_data->effect_volume();
-    slider_value_music_ = save_data->music_volume();
-
-    world_->SetRenderingOption(kRenderingMonoscopic, kShadowEffect,
-                               save_data->render_shadows());
-    world_->SetRenderingOption(kRenderingMonoscopic, kPhongShading,
-                               save_data->apply_phong());
-    world_->SetRenderingOption(kRenderingMonoscopic, kSpecularEffect,
-                               save_data->apply_specular());
-    world_->SetRenderingOption(kRenderingStereoscopic, kShadowEffect,
-                               save_data->render_shadows_cardboard());
-    world_->SetRenderingOption(kRenderingStereoscopic, kPhongShading,
-                               save_data->apply_phong_cardboard());
-    world_->SetRenderingOption(kRenderingStereoscopic, kSpecularEffect,
-                               save_data->apply_specular_cardboard());
+  if (!world_->save_manager->has_settings()) return;
+  const SaveSettings settings = world_->save_manager->settings();
+  slider_value_effect_ = settings.effect_volume;
+  slider_value_music_ = settings.music_volume;
+
+  world_->SetRenderingOption(kRenderingMonoscopic, kShadowEffect,
+                             settings.render_shadows);
+  world_->SetRenderingOption(kRenderingMonoscopic, kPhongShading,
+                             settings.apply_phong);
+  world_->SetRenderingOption(kRenderingMonoscopic, kSpecularEffect,
+                             settings.apply_specular);
+  world_->SetRenderingOption(kRenderingStereoscopic, kShadowEffect,
+                             settings.render_shadows_cardboard);
+  world_->SetRenderingOption(kRenderingStereoscopic, kPhongShading,
+                             settings.apply_phong_cardboard);
+  world_->SetRenderingOption(kRenderingStereoscopic, kSpecularEffect,
+                             settings.apply_specular_cardboard);
 #if FPLBASE_ANDROID_VR
-    world_->SetHmdControllerEnabled(save_data->gyroscopic_controls_enabled() !=
-                                    0);
+  world_->SetHmdControllerEnabled(settings.gyroscopic_controls_enabled);
 #endif  // FPLBASE_ANDROID_VR
-  }
 }
 
 void GameMenuState::SaveData() {
-  // Create FlatBuffer for save data.
-  flatbuffers::FlatBufferBuilder fbb;
-  SaveDataBuilder builder(fbb);
-  builder.add_effect_volume(slider_value_effect_);
-  builder.add_music_volume(slider_value_music_);
-  builder.add_render_shadows(
-      world_->RenderingOptionEnabled(kRenderingMonoscopic, kShadowEffect));
-  builder.add_apply_phong(
-      world_->RenderingOptionEnabled(kRenderingMonoscopic, kPhongShading));
-  builder.add_apply_specular(
-      world_->RenderingOptionEnabled(kRenderingMonoscopic, kSpecularEffect));
-  builder.add_render_shadows_cardboard(
-      world_->RenderingOptionEnabled(kRenderingStereoscopic, kShadowEffect));
-  builder.add_apply_phong_cardboard(
-      world_->RenderingOptionEnabled(kRenderingStereoscopic, kPhongShading));
-  builder.add_apply_specular_cardboard(
-      world_->RenderingOptionEnabled(kRenderingStereoscopic, kSpecularEffect));
+  // Start from the saved settings, so that any not changed here keep their
+  // values.
+  SaveSettings settings = world_->save_manager->settings();
+  settings.effect_volume = slider_value_effect_;
+  settings.music_volume = slider_value_music_;
+  settings.render_shadows =
+      world_->RenderingOptionEnabled(kRenderingMonoscopic, kShadowEffect);
+  settings.apply_phong =
+      world_->RenderingOptionEnabled(kRenderingMonoscopic, kPhongShading);
+  settings.apply_specular =
+      world_->RenderingOptionEnabled(kRenderingMonoscopic, kSpecularEffect);
+  settings.render_shadows_cardboard =
+      world_->RenderingOptionEnabled(kRenderingStereoscopic, kShadowEffect);
+  settings.apply_phong_cardboard =
+      world_->RenderingOptionEnabled(kRenderingStereoscopic, kPhongShading);
+  settings.apply_specular_cardboard =
+      world_->RenderingOptionEnabled(kRenderingStereoscopic, kSpecularEffect);
 #if FPLBASE_ANDROID_VR
-  builder.add_gyroscopic_controls_enabled(
-      world_->GetHmdControllerEnabled() ? 1 : 0);
+  settings.gyroscopic_controls_enabled = world_->GetHmdControllerEnabled();
 #endif  // FPLBASE_ANDROID_VR
-  auto offset = builder.Finish();
-  FinishSaveDataBuffer(fbb, offset);
-
-  // Retrieve save file path.
-  std::string storage_path;
-  auto ret = fplbase::GetStoragePath(kSaveAppName, &storage_path);
-  if (ret) {
-    fplbase::SavePreferences((storage_path + kSaveFileName).c_str(),
-                             fbb.GetBufferPointer(), fbb.GetSize());
-  }
+
+  // Written out in the background by the save manager.
+  world_->save_manager->set_settings(settings);
 }
 
 void GameMenuState::UpdateVolumes() {
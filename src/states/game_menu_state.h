@@ -22,6 +22,7 @@
 #include "fplbase/input.h"
 #include "gpg_manager.h"
 #include "pindrop/pindrop.h"
+#include "retained_text.h"
 #include "states/gameplay_state.h"
 #include "states/state_machine.h"
 
@@ -92,8 +93,6 @@ const auto kScoreAccuracyFactor = 50.0f;
 
 const auto kEffectVolumeDefault = 1.0f;
 const auto kMusicVolumeDefault = 1.0f;
-const auto kSaveFileName = "save_data.zoosave";
-const auto kSaveAppName = "zooshi";
 
 class GameMenuState : public StateNode {
  public:
@@ -267,8 +266,9 @@ class GameMenuState : public StateNode {
 
   // Option menu state.
   mathfu::vec2 scroll_offset_;
-  std::string license_text_;
-  std::string about_text_;
+  // Only the visible part of these is laid out each frame.
+  RetainedText license_text_;
+  RetainedText about_text_;
 
   // In-game menu state.
   OptionsMenuState options_menu_state_;
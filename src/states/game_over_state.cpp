@@ -138,43 +138,30 @@ void GameOverState::OnEnter(int /*previous_state*/) {
   static const corgi::WorldTime kEndGameEventTime = 0;
   world_->patron_component.StartEvent(kEndGameEventTime);
 
+  // Compare against the locally kept best, which the leaderboard service has
+  // already reconciled with the server, so entering this state never waits
+  // on the network.
+  auto player = world_->player_component.begin()->entity;
+  auto score = world_->attributes_component.GetAttribute(
+      player, AttributeDef_PatronsFed);
+  const std::string leaderboard_id =
+      LeaderboardId(config_->gpg_config(), kGPGDefaultLeaderboard);
   bool high_score = false;
-
-#ifdef USING_GOOGLE_PLAY_GAMES
-  if (gpg_manager_->LoggedIn()) {
-    // Finished a game, post a score.
-    auto player = world_->player_component.begin()->entity;
-    auto attribute_data =
-        world_->entity_manager.GetComponentData<AttributesData>(player);
-    auto score = attribute_data->attributes[AttributeDef_PatronsFed];
-    auto leaderboard_config = config_->gpg_config()->leaderboards();
-    std::string leaderboard_id =
-        leaderboard_config->LookupByKey(kGPGDefaultLeaderboard)->id()->c_str();
-
-    // Check if we have a new high score.
-    high_score = score > gpg_manager_->CurrentPlayerHighScore(leaderboard_id);
-
-    // Submit score.
-    gpg_manager_->SubmitScore(leaderboard_id, score);
+  if (!leaderboard_id.empty()) {
+    high_score = world_->leaderboard->ReportScore(
+        leaderboard_id, static_cast<int64_t>(score));
   }
-#endif
 
-  auto player = world_->player_component.begin()->entity;
-  auto attribute_data =
-      world_->entity_manager.GetComponentData<AttributesData>(player);
-  auto score = attribute_data->attributes[AttributeDef_PatronsFed];
-  firebase::analytics::LogEvent(firebase::analytics::kEventPostScore,
-                                firebase::analytics::kParameterScore,
-                                static_cast<int64_t>(score));
-  firebase::analytics::Parameter parameters[] = {
-      firebase::analytics::Parameter(
-          kParameterElapsedLevelTime,
-          static_cast<float>(input_system_->Time() -
-                             world_->gameplay_start_time)),
-      AnalyticsControlParameter(world_),
-  };
-  firebase::analytics::LogEvent(kEventGameplayFinished, parameters,
-                                sizeof(parameters) / sizeof(parameters[0]));
+  world_->analytics.LogEvent(
+      AnalyticsEvent(kAnalyticsEventPostScore)
+          .AddInt(kAnalyticsParameterScore, static_cast<int64_t>(score)));
+  world_->analytics.LogEvent(
+      AnalyticsEvent(kAnalyticsEventGameplayFinished)
+          .AddFloat(kAnalyticsParameterElapsedLevelTime,
+                    static_cast<float>(input_system_->Time() -
+                                       world_->gameplay_start_time))
+          .AddName(kAnalyticsParameterControlScheme,
+                   AnalyticsControlValue(world_)));
 
   if (high_score) {
     game_over_channel_ = audio_engine_->PlaySound(sound_high_score_);
@@ -90,7 +90,9 @@ static void UpdateMusic(corgi::EntityManager* entity_manager, int* previous_lap,
 }
 
 void GameplayState::AdvanceFrame(int delta_time, int* next_state) {
-  // Update the world.
+  // Update the world. The raft only moves along its rail during gameplay, so
+  // this is the only state that streams.
+  world_->level_streamer.Update(world_);
   world_->entity_manager.UpdateComponents(delta_time);
   UpdateMainCamera(&main_camera_, world_);
   UpdateMusic(&world_->entity_manager, &previous_lap_, &percent_, delta_time,
@@ -142,7 +144,11 @@ void GameplayState::Render(fplbase::Renderer* renderer) {
 #if FPLBASE_ANDROID_VR
   cardboard_camera = &cardboard_camera_;
 #endif
-  RenderWorld(*renderer, world_, main_camera_, cardboard_camera, input_system_);
+  // The camera orientation was computed on the update thread from last frame's
+  // input; patch in this frame's before drawing.
+  Camera camera = main_camera_;
+  LateLatchCamera(&camera, world_);
+  RenderWorld(*renderer, world_, camera, cardboard_camera, input_system_);
   if (!fader_->Finished()) {
     renderer->set_model_view_projection(
         mathfu::mat4::Ortho(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f));
@@ -203,6 +209,12 @@ void GameplayState::OnEnter(int previous_state) {
     music_channel_lap_2_.Resume();
     music_channel_lap_3_.Resume();
   } else {
+    // Refresh the best score while the game is played, so it is ready by the
+    // time the game ends.
+    const std::string leaderboard_id =
+        LeaderboardId(config_->gpg_config(), kGPGDefaultLeaderboard);
+    if (!leaderboard_id.empty()) world_->leaderboard->Prefetch(leaderboard_id);
+
     music_channel_lap_1_ =
         audio_engine_->PlaySound(music_gameplay_lap_1_, mathfu::kZeros3f, 1.0f);
     music_channel_lap_2_ =
@@ -226,9 +238,10 @@ void GameplayState::OnEnter(int previous_state) {
   if (previous_state != kGameStatePause) {
     // Set the start time, so elapsed time can be tracked.
     world_->gameplay_start_time = input_system_->Time();
-    firebase::analytics::LogEvent(kEventGameplayStart,
-                                  kParameterControlScheme,
-                                  AnalyticsControlValue(world_));
+    world_->analytics.LogEvent(
+        AnalyticsEvent(kAnalyticsEventGameplayStart)
+            .AddName(kAnalyticsParameterControlScheme,
+                     AnalyticsControlValue(world_)));
   }
 }
 
@@ -28,6 +28,7 @@
 #include "fplbase/shader.h"
 #include "fplbase/utilities.h"
 #include "full_screen_fader.h"
+#include "glyph_prewarm.h"
 #include "mathfu/constants.h"
 #include "mathfu/glsl_mappings.h"
 #include "mathfu/matrix.h"
@@ -102,9 +103,18 @@ void LoadingState::AdvanceFrame(int delta_time, int* next_state) {
 void LoadingState::Render(fplbase::Renderer* renderer) {
   // Ensure assets are instantiated after they've been loaded.
   // This must be called from the render thread.
-  loading_complete_ =
+  const bool assets_loaded =
       asset_manager_->TryFinalize() && audio_engine_->TryFinalize();
 
+  // Rasterize the glyphs the game will need now, rather than the first time
+  // each one is shown in game.
+  if (assets_loaded && !glyphs_prewarmed_) {
+    PrewarmGlyphs(*world_->config, asset_manager_,
+                  world_->services_component.font_manager(), input_system_);
+    glyphs_prewarmed_ = true;
+  }
+  loading_complete_ = assets_loaded && glyphs_prewarmed_;
+
   // Get a handle to the loading material.
   const char* loading_material_name =
       asset_manifest_->loading_material()->c_str();
@@ -36,6 +36,7 @@ class LoadingState : public StateNode {
  public:
   LoadingState()
       : loading_complete_(false),
+        glyphs_prewarmed_(false),
         asset_manager_(nullptr),
         asset_manifest_(nullptr),
         shader_textured_(nullptr),
@@ -56,6 +57,10 @@ class LoadingState : public StateNode {
   // loaded. The update thread then transitions to the next state.
   bool loading_complete_;
 
+  // Set once the configured glyphs have been rasterized. Loading is not
+  // complete until then.
+  bool glyphs_prewarmed_;
+
   // Holds the texture asynchronous loader thread that we are waiting for.
   // Also holds the loading texture that we display on screen.
   fplbase::AssetManager* asset_manager_;
@@ -49,6 +49,10 @@ void SceneLabState::Initialize(fplbase::Renderer* renderer,
 
 void SceneLabState::AdvanceFrame(corgi::WorldTime delta_time, int* next_state) {
   scene_lab_->AdvanceFrame(delta_time);
+  // Rebuild whatever this frame's edits touched, once, however many edit
+  // events there were.
+  world_->edit_dependencies.Rebuild(
+      EditDependencyTracker::kRebuildWhileEditing);
   if (input_system_->GetButton(fplbase::FPLK_F11).went_down()) {
     scene_lab_->SaveScene();
   }
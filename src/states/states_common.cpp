@@ -124,6 +124,23 @@ void RenderWorld(fplbase::Renderer& renderer, World* world, Camera& camera,
   }
 }
 
+void LateLatchCamera(Camera* camera, World* world) {
+  auto player = world->player_component.begin()->entity;
+  auto player_data = world->entity_manager.GetComponentData<PlayerData>(player);
+  if (!player_data || !player_data->input_controller()) return;
+  vec3 facing;
+  vec3 up;
+  if (!player_data->input_controller()->LatestOrientation(&facing, &up)) {
+    return;
+  }
+  // Same transformation as UpdateMainCamera: the controller's vectors are
+  // relative to the raft.
+  auto raft_orientation = world->transform_component.WorldOrientation(
+      world->entity_manager.GetComponent<ServicesComponent>()->raft_entity());
+  camera->set_facing(raft_orientation.Inverse() * facing);
+  camera->set_up(raft_orientation.Inverse() * up);
+}
+
 void UpdateMainCamera(Camera* main_camera, World* world) {
   auto player = world->player_component.begin()->entity;
   auto transform_component = &world->transform_component;
@@ -26,6 +26,12 @@ namespace zooshi {
 // Update the camera to the location of the player in the given world.
 void UpdateMainCamera(Camera* camera, World* world);
 
+// Re-sample the player's input controller and patch the camera's facing and
+// up vectors with the result. Call on the render thread, after the input has
+// been pumped, so the view doesn't lag a frame behind the latest input. The
+// camera position is left as the simulation computed it.
+void LateLatchCamera(Camera* camera, World* world);
+
 // Render the world monoscopically or stereoscopically.
 void RenderWorld(fplbase::Renderer& renderer, World* world, Camera& camera,
                  Camera* cardboard_camera, fplbase::InputSystem* input_system);
@@ -0,0 +1,106 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stats_registry.h"
+
+#include "fplbase/utilities.h"
+
+namespace fpl {
+namespace zooshi {
+
+// Weight of the newest value in each stat's moving average.
+static const double kAverageWeight = 0.05;
+
+StatId StatsRegistry::Register(const char* name, StatKind kind,
+                               bool per_frame) {
+  stats_.push_back(Stat());
+  Stat& stat = stats_.back();
+  stat.name = name;
+  stat.kind = kind;
+  stat.per_frame = per_frame;
+  return static_cast<StatId>(stats_.size() - 1);
+}
+
+StatId StatsRegistry::RegisterSampler(const char* name, StatKind kind,
+                                      const Sampler& sampler) {
+  const StatId id = Register(name, kind, false);
+  stats_[id].sampler = sampler;
+  return id;
+}
+
+void StatsRegistry::Latch() {
+  for (auto it = stats_.begin(); it != stats_.end(); ++it) {
+    if (it->sampler) it->value = it->sampler();
+    it->latched = it->value;
+    it->average = frame_ == 0 ? it->value
+                              : it->average +
+                                    kAverageWeight * (it->value - it->average);
+    if (it->per_frame) it->value = 0.0;
+  }
+  frame_++;
+}
+
+bool StatsLogger::Open(const StatsLogDef& def) {
+  Close();
+  if (def.file() == nullptr || def.file()->size() == 0) return false;
+  file_ = fopen(def.file()->c_str(), "w");
+  if (file_ == nullptr) {
+    fplbase::LogError("StatsLogger: couldn't open %s", def.file()->c_str());
+    return false;
+  }
+  format_ = def.format();
+  interval_frames_ = def.interval_frames() > 0 ? def.interval_frames() : 1;
+  header_size_ = 0;
+  fplbase::LogInfo("StatsLogger: writing stats to %s", def.file()->c_str());
+  return true;
+}
+
+void StatsLogger::Close() {
+  if (file_ == nullptr) return;
+  fclose(file_);
+  file_ = nullptr;
+}
+
+void StatsLogger::WriteHeader(const StatsRegistry& stats) {
+  header_size_ = stats.size();
+  fprintf(file_, "frame");
+  for (StatId id = 0; id < header_size_; ++id) {
+    fprintf(file_, ",%s", stats.name(id).c_str());
+  }
+  fprintf(file_, "\n");
+}
+
+void StatsLogger::Update(const StatsRegistry& stats) {
+  if (file_ == nullptr || stats.frame() % interval_frames_ != 0) return;
+
+  const unsigned long long frame =
+      static_cast<unsigned long long>(stats.frame());
+  if (format_ == StatsLogFormat_CSV) {
+    if (header_size_ == 0) WriteHeader(stats);
+    fprintf(file_, "%llu", frame);
+    for (StatId id = 0; id < header_size_; ++id) {
+      fprintf(file_, ",%g", stats.latched(id));
+    }
+  } else {
+    fprintf(file_, "{\"frame\":%llu", frame);
+    for (StatId id = 0; id < stats.size(); ++id) {
+      fprintf(file_, ",\"%s\":%g", stats.name(id).c_str(), stats.latched(id));
+    }
+    fprintf(file_, "}");
+  }
+  fprintf(file_, "\n");
+}
+
+}  // zooshi
+}  // fpl
@@ -0,0 +1,163 @@
+// Copyright 2015 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZOOSHI_STATS_REGISTRY_H_
+#define ZOOSHI_STATS_REGISTRY_H_
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "SDL_timer.h"
+#include "config_generated.h"
+
+namespace fpl {
+namespace zooshi {
+
+typedef uint16_t StatId;
+
+// How a stat is displayed and logged.
+enum StatKind {
+  kStatKindCount,
+  kStatKindMilliseconds,
+  kStatKindBytes,
+};
+
+// A flat registry of named runtime counters: entity counts, render and
+// physics totals, allocations, per-phase timings, and so on.
+//
+// A stat is either pushed by the code that measures it (Set() or Add()), or
+// pulled by a sampler function when the registry is latched. Latch() runs
+// once per frame with the game update lock held; it runs the samplers,
+// publishes every value for readers, and zeroes the per-frame stats. The
+// HUD and the logger only read latched values, so they may run on the render
+// thread without the lock.
+//
+// Each pushed stat must only be written from one thread.
+class StatsRegistry {
+ public:
+  typedef std::function<double()> Sampler;
+
+  StatsRegistry() : frame_(0) {}
+
+  // Register a pushed stat. If `per_frame` is set, it is zeroed after every
+  // latch, so Add() accumulates over one frame.
+  StatId Register(const char* name, StatKind kind, bool per_frame);
+
+  // Register a stat whose value is read from `sampler` at every latch.
+  StatId RegisterSampler(const char* name, StatKind kind,
+                         const Sampler& sampler);
+
+  void Set(StatId id, double value) {
+    assert(id < stats_.size());
+    stats_[id].value = value;
+  }
+  void Add(StatId id, double value) {
+    assert(id < stats_.size());
+    stats_[id].value += value;
+  }
+
+  // Sample, publish and reset. Call once per frame.
+  void Latch();
+
+  size_t size() const { return stats_.size(); }
+  const std::string& name(StatId id) const { return stats_[id].name; }
+  StatKind kind(StatId id) const { return stats_[id].kind; }
+
+  // The value published by the last Latch().
+  double latched(StatId id) const { return stats_[id].latched; }
+  // An exponential moving average of the latched values, for display.
+  double average(StatId id) const { return stats_[id].average; }
+
+  // Number of times Latch() has been called.
+  uint64_t frame() const { return frame_; }
+
+ private:
+  struct Stat {
+    Stat()
+        : kind(kStatKindCount),
+          per_frame(false),
+          value(0.0),
+          latched(0.0),
+          average(0.0) {}
+    std::string name;
+    StatKind kind;
+    bool per_frame;
+    Sampler sampler;
+    double value;
+    double latched;
+    double average;
+  };
+
+  std::vector<Stat> stats_;
+  uint64_t frame_;
+};
+
+// Sets a millisecond stat to the time spent in the enclosing scope.
+class ScopedStatTimer {
+ public:
+  ScopedStatTimer(StatsRegistry* stats, StatId id)
+      : stats_(stats), id_(id), start_(SDL_GetPerformanceCounter()) {}
+  ~ScopedStatTimer() {
+    const uint64_t elapsed = SDL_GetPerformanceCounter() - start_;
+    stats_->Set(id_, 1000.0 * static_cast<double>(elapsed) /
+                         static_cast<double>(SDL_GetPerformanceFrequency()));
+  }
+
+ private:
+  StatsRegistry* stats_;
+  StatId id_;
+  uint64_t start_;
+};
+
+// Appends latched stats to a file, for soak tests. CSV files get a header
+// row of stat names followed by one row per sample; JSON files get one
+// object per line.
+class StatsLogger {
+ public:
+  StatsLogger()
+      : file_(nullptr),
+        format_(StatsLogFormat_CSV),
+        interval_frames_(1),
+        header_size_(0) {}
+  ~StatsLogger() { Close(); }
+
+  bool Open(const StatsLogDef& def);
+  void Close();
+  bool is_open() const { return file_ != nullptr; }
+
+  // Write a sample if the registry's frame count falls on the interval.
+  void Update(const StatsRegistry& stats);
+
+ private:
+  StatsLogger(const StatsLogger&);
+  StatsLogger& operator=(const StatsLogger&);
+
+  void WriteHeader(const StatsRegistry& stats);
+
+  FILE* file_;
+  StatsLogFormat format_;
+  int interval_frames_;
+  // Number of stats named in the CSV header. Stats registered after the
+  // header is written are left out of the CSV.
+  size_t header_size_;
+};
+
+}  // zooshi
+}  // fpl
+
+#endif  // ZOOSHI_STATS_REGISTRY_H_
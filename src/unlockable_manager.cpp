@@ -15,6 +15,7 @@
 #include "unlockable_manager.h"
 
 #include "fplbase/utilities.h"
+#include "save_manager.h"
 
 #ifdef _WIN32
 #define snprintf(buffer, count, format, ...) \
@@ -32,12 +33,19 @@ void UnlockableManager::InitializeType(
         flatbuffers::Offset<fpl::zooshi::UnlockableConfig>>* config) {
   configs_[type] = config;
   unlockables_[type].resize(config->size());
+  const bool has_progress = save_manager_->has_progress();
   char buffer[kBufferSize];
   for (int i = 0; i < static_cast<int>(config->size()); ++i) {
     bool unlocked = true;
     if (!config->Get(i)->starts_unlocked()) {
-      GetPreferenceString(buffer, kBufferSize, type, i);
-      unlocked = fplbase::LoadPreference(buffer, 0) != 0;
+      if (has_progress) {
+        unlocked = save_manager_->IsUnlocked(type, i);
+      } else {
+        // Older versions kept one preference per unlockable.
+        GetPreferenceString(buffer, kBufferSize, type, i);
+        unlocked = fplbase::LoadPreference(buffer, 0) != 0;
+        save_manager_->SetUnlocked(type, i, unlocked);
+      }
     }
     unlockables_[type][i] = unlocked;
     if (!unlocked) {
@@ -57,9 +65,7 @@ void UnlockableManager::SetUnlock(UnlockableType type, size_t index,
     unlockables_[type][index] = unlocked;
     remaining_locked_[type] += unlocked ? -1 : 1;
     remaining_locked_total_ += unlocked ? -1 : 1;
-    char buffer[kBufferSize];
-    GetPreferenceString(buffer, kBufferSize, type, index);
-    fplbase::SavePreference(buffer, unlocked ? 1 : 0);
+    save_manager_->SetUnlocked(type, index, unlocked);
   }
 }
 
@@ -35,9 +35,14 @@ struct Unlockable {
   const UnlockableConfig* config;
 };
 
+class SaveManager;
+
 // Tracks the unlockables of the game.
 class UnlockableManager {
  public:
+  // Unlock state is loaded from and saved to `save_manager`.
+  void Initialize(SaveManager* save_manager) { save_manager_ = save_manager; }
+
   // Initialize the given type with the provided config data.
   void InitializeType(
       UnlockableType type,
@@ -67,6 +72,7 @@ class UnlockableManager {
                            size_t index);
   void SetUnlock(UnlockableType type, size_t index, bool unlocked);
 
+  SaveManager* save_manager_;
   // The cached configuration value for each type.
   const flatbuffers::Vector<flatbuffers::Offset<fpl::zooshi::UnlockableConfig>>*
       configs_[UnlockableType_Size];
@@ -56,14 +56,35 @@ static const char kEntityLibraryFile[] = "entity_prototypes.zooentity";
 static const char kComponentDefBinarySchema[] =
     "flatbufferschemas/components.bfbs";
 
+// Count the visible render meshes. If `per_pass` is set, a mesh counts once
+// for every render pass it is drawn in.
+static size_t CountVisibleMeshes(World* world, bool per_pass) {
+  size_t count = 0;
+  auto* render_mesh_component = &world->render_mesh_component;
+  for (auto iter = render_mesh_component->begin();
+       iter != render_mesh_component->end(); ++iter) {
+    const corgi::component_library::RenderMeshData& data = iter->data;
+    if (!data.visible || data.mesh == nullptr) continue;
+    if (!per_pass) {
+      count++;
+      continue;
+    }
+    for (int pass = 0; pass < corgi::RenderPass_Count; pass++) {
+      if (data.pass_mask & (1 << pass)) count++;
+    }
+  }
+  return count;
+}
+
 void World::Initialize(
     const Config& config_, fplbase::InputSystem* input_system,
     fplbase::AssetManager* asset_mgr, WorldRenderer* worldrenderer,
     flatui::FontManager* font_manager, pindrop::AudioEngine* audio_engine,
     breadboard::GraphFactory* graph_factory, fplbase::Renderer* renderer,
     SceneLab* scene_lab, UnlockableManager* unlockable_mgr, XpSystem* xpsystem,
-    InvitesListener* invites_lstr, MessageListener* message_lstr,
-    AdMobHelper* admob_hlpr) {
+    SaveManager* save_mgr, InvitesListener* invites_lstr,
+    MessageListener* message_lstr, AdMobHelper* admob_hlpr,
+    RemoteConfig* remote_cfg, LeaderboardService* leaderboard_svc) {
   entity_factory.reset(new corgi::component_library::DefaultEntityFactory());
   motive::SplineInit::Register();
   motive::MatrixInit::Register();
@@ -74,6 +95,7 @@ void World::Initialize(
   world_renderer = worldrenderer;
   unlockables = unlockable_mgr;
   xp_system = xpsystem;
+  save_manager = save_mgr;
 
   config = &config_;
 
@@ -200,6 +222,196 @@ void World::Initialize(
   invites_listener = invites_lstr;
   message_listener = message_lstr;
   admob_helper = admob_hlpr;
+  remote_config = remote_cfg;
+  leaderboard = leaderboard_svc;
+
+  if (scene_lab != nullptr) RegisterEditorCallbacks(scene_lab);
+  RegisterDiagnostics();
+}
+
+// Report the memory and entity count of `component` under `name`.
+template <typename ComponentT>
+static void RegisterComponentDiagnostics(World* world, const char* name,
+                                         ComponentT* component) {
+  RegisterComponentMemory(&world->memory, name, component);
+  world->stats.RegisterSampler(name, kStatKindCount, [component]() {
+    return static_cast<double>(ComponentEntityCount(component));
+  });
+}
+
+void World::RegisterDiagnostics() {
+  RegisterGameStats(&stats);
+
+  // Render totals. These are upper bounds: they count every visible mesh in
+  // every pass it belongs to, before frustum culling.
+  World* world = this;
+  stats.RegisterSampler("visible meshes", kStatKindCount, [world]() {
+    return static_cast<double>(CountVisibleMeshes(world, false));
+  });
+  stats.RegisterSampler("draw calls", kStatKindCount, [world]() {
+    const size_t shadow_casters =
+        world->RenderingOptionEnabled(kShadowEffect)
+            ? CountVisibleMeshes(world, false)
+            : 0;
+    return static_cast<double>(CountVisibleMeshes(world, true) +
+                               shadow_casters);
+  });
+  stats.RegisterSampler("shadow casters", kStatKindCount, [world]() {
+    return static_cast<double>(world->RenderingOptionEnabled(kShadowEffect)
+                                   ? CountVisibleMeshes(world, false)
+                                   : 0);
+  });
+  stats.RegisterSampler("active rigs", kStatKindCount, [world]() {
+    return static_cast<double>(
+        ComponentEntityCount(&world->animation_component));
+  });
+  stats.RegisterSampler("physics bodies", kStatKindCount, [world]() {
+    return static_cast<double>(
+        ComponentEntityCount(&world->physics_component));
+  });
+
+  RegisterComponentDiagnostics(this, "transform", &transform_component);
+  RegisterComponentDiagnostics(this, "animation", &animation_component);
+  RegisterComponentDiagnostics(this, "rail denizen", &rail_denizen_component);
+  RegisterComponentDiagnostics(this, "player", &player_component);
+  RegisterComponentDiagnostics(this, "player projectile",
+                               &player_projectile_component);
+  RegisterComponentDiagnostics(this, "render mesh", &render_mesh_component);
+  RegisterComponentDiagnostics(this, "physics", &physics_component);
+  RegisterComponentDiagnostics(this, "patron", &patron_component);
+  RegisterComponentDiagnostics(this, "time limit", &time_limit_component);
+  RegisterComponentDiagnostics(this, "audio listener",
+                               &audio_listener_component);
+  RegisterComponentDiagnostics(this, "sound", &sound_component);
+  RegisterComponentDiagnostics(this, "attributes", &attributes_component);
+  RegisterComponentDiagnostics(this, "river", &river_component);
+  RegisterComponentDiagnostics(this, "rail node", &rail_node_component);
+  RegisterComponentDiagnostics(this, "scenery", &scenery_component);
+  RegisterComponentDiagnostics(this, "light", &light_component);
+  RegisterComponentDiagnostics(this, "shadow controller",
+                               &shadow_controller_component);
+  RegisterComponentDiagnostics(this, "meta", &meta_component);
+  RegisterComponentDiagnostics(this, "edit options", &edit_options_component);
+  RegisterComponentDiagnostics(this, "simple movement",
+                               &simple_movement_component);
+  RegisterComponentDiagnostics(this, "lap dependent", &lap_dependent_component);
+  // Only the GraphData structs are counted. The breadboard graph instances
+  // they own are allocated inside breadboard, which offers no way to measure
+  // them, so they are missing from the snapshot.
+  RegisterComponentDiagnostics(this, "graph data", &graph_component);
+  RegisterComponentDiagnostics(this, "render 3d text",
+                               &render_3d_text_component);
+
+  RiverComponent* rivers = &river_component;
+  memory.Register("river meshes", [rivers]() { return rivers->MeshBytes(); });
+  memory.Register("river collision",
+                  [rivers]() { return rivers->CollisionMeshBytes(); });
+
+  const RailManager* rails = &rail_manager;
+  memory.Register("rails", [rails]() { return rails->MemoryBytes(); });
+
+  const LevelStreamer* streamer = &level_streamer;
+  memory.Register("level streaming",
+                  [streamer]() { return streamer->MemoryBytes(); });
+  stats.RegisterSampler("streamed chunks", kStatKindCount, [streamer]() {
+    return static_cast<double>(streamer->loaded_chunk_count());
+  });
+  stats.RegisterSampler("streamed entities", kStatKindCount, [streamer]() {
+    return static_cast<double>(streamer->LoadedEntityCount());
+  });
+}
+
+// Register the rail `rail_name` as derived data, built from its rail nodes.
+// Returns its key.
+static std::string RecordRailDependency(World* world,
+                                        const std::string& rail_name) {
+  const std::string key = "rail:" + rail_name;
+  world->edit_dependencies.AddDerivedData(
+      key, EditDependencyTracker::kRebuildWhileEditing, [world, rail_name]() {
+        world->rail_denizen_component.RebuildRail(rail_name);
+      });
+  return key;
+}
+
+void World::RecordEditDependencies(const std::string& entity_id,
+                                   const corgi::EntityRef& entity) {
+  EditDependencyTracker* deps = &edit_dependencies;
+
+  const RailNodeData* rail_node = rail_node_component.GetComponentData(entity);
+  if (rail_node != nullptr) {
+    deps->AddEntityDependency(RecordRailDependency(this, rail_node->rail_name),
+                              entity_id);
+  }
+
+  // The river mesh, and its bank collision mesh, follow the river's rail.
+  const RiverData* river = river_component.GetComponentData(entity);
+  if (river != nullptr) {
+    const std::string key = "river:" + entity_id;
+    deps->AddDerivedData(key, EditDependencyTracker::kRebuildWhileEditing,
+                         [this, entity]() {
+                           if (!entity.IsValid()) return;
+                           river_component.TriggerRiverUpdate(entity);
+                         });
+    deps->AddEntityDependency(key, entity_id);
+    deps->AddDependency(key, RecordRailDependency(this, river->rail_name));
+  }
+
+  // Rail offsets copied from the transform, and the render children patrons
+  // and scenery animate, are only fixed up once editing is done, since the
+  // game would otherwise move them while they are being placed.
+  if (rail_denizen_component.GetComponentData(entity) != nullptr) {
+    const std::string key = "rail_denizen:" + entity_id;
+    deps->AddDerivedData(key, EditDependencyTracker::kRebuildOnExit,
+                         [this, entity]() mutable {
+                           if (!entity.IsValid()) return;
+                           rail_denizen_component.EntityPostLoadFixup(entity);
+                         });
+    deps->AddEntityDependency(key, entity_id);
+  }
+  if (patron_component.GetComponentData(entity) != nullptr) {
+    const std::string key = "patron:" + entity_id;
+    deps->AddDerivedData(key, EditDependencyTracker::kRebuildOnExit,
+                         [this, entity]() mutable {
+                           if (!entity.IsValid()) return;
+                           patron_component.CacheEntityLinks(entity);
+                         });
+    deps->AddEntityDependency(key, entity_id);
+  }
+  if (scenery_component.GetComponentData(entity) != nullptr) {
+    const std::string key = "scenery:" + entity_id;
+    deps->AddDerivedData(key, EditDependencyTracker::kRebuildOnExit,
+                         [this, entity]() mutable {
+                           if (!entity.IsValid()) return;
+                           scenery_component.CacheEntityLinks(entity);
+                         });
+    deps->AddEntityDependency(key, entity_id);
+  }
+}
+
+void World::RegisterEditorCallbacks(SceneLab* scene_lab) {
+  scene_lab->AddOnEnterEditorCallback([this]() {
+    // Scene Lab can only edit and save the entities that exist.
+    level_streamer.StopStreaming(this);
+    edit_dependencies.Clear();
+    for (auto iter = meta_component.begin(); iter != meta_component.end();
+         ++iter) {
+      RecordEditDependencies(iter->data.entity_id, iter->entity);
+    }
+  });
+  scene_lab->AddOnUpdateEntityCallback(
+      [this, scene_lab](const scene_lab::GenericEntityId& id) {
+        corgi::EntityRef entity =
+            static_cast<scene_lab_corgi::CorgiAdapter*>(
+                scene_lab->entity_system_adapter())->GetEntityRef(id);
+        // Entities created in the editor, or given a new rail, are picked up
+        // here. Dependencies are only ever added, so a rail node moved to
+        // another rail still rebuilds the rail it left.
+        if (entity.IsValid()) RecordEditDependencies(id, entity);
+        edit_dependencies.InvalidateEntity(id);
+      });
+  scene_lab->AddOnExitEditorCallback([this]() {
+    edit_dependencies.Rebuild(EditDependencyTracker::kRebuildOnExit);
+  });
 }
 
 void World::AddController(BasePlayerController* controller) {
@@ -273,26 +485,33 @@ bool World::RenderingOptionEnabled(RenderingMode rendering_mode,
   return rendering_options_[rendering_mode][s];
 }
 
+static void LoadEntityFiles(
+    World* world,
+    const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>*
+        entity_files) {
+  if (entity_files == nullptr) return;
+  for (flatbuffers::uoffset_t i = 0; i < entity_files->size(); i++) {
+    const char* filename = entity_files->Get(i)->c_str();
+    world->entity_factory->LoadEntitiesFromFile(filename,
+                                                &world->entity_manager);
+  }
+}
+
 void LoadWorldDef(World* world, const WorldDef* world_def) {
+  world->level_streamer.Clear();
   for (auto iter = world->entity_manager.begin();
        iter != world->entity_manager.end(); ++iter) {
     world->entity_manager.DeleteEntity(iter.ToReference());
   }
   world->entity_manager.DeleteMarkedEntities();
   assert(world->entity_manager.begin() == world->entity_manager.end());
-  for (size_t i = 0; i < world_def->entity_files()->size(); i++) {
-    flatbuffers::uoffset_t index = static_cast<flatbuffers::uoffset_t>(i);
-    const char* filename = world_def->entity_files()->Get(index)->c_str();
-    world->entity_factory->LoadEntitiesFromFile(filename,
-                                                &world->entity_manager);
-  }
+  LoadEntityFiles(world, world_def->entity_files());
   const LevelDef* level_def = world_def->levels()->Get(
     static_cast<flatbuffers::uoffset_t>(world->level_index));
-  for (size_t i = 0; i < level_def->entity_files()->size(); i++) {
-    const char* filename = level_def->entity_files()->Get(
-      static_cast<flatbuffers::uoffset_t>(i))->c_str();
-    world->entity_factory->LoadEntitiesFromFile(filename,
-                                                &world->entity_manager);
+  LoadEntityFiles(world, level_def->entity_files());
+  // Without streaming settings, streamed files are simply loaded up front.
+  if (level_def->streaming() == nullptr) {
+    LoadEntityFiles(world, level_def->streamed_entity_files());
   }
 
   world->SetActiveController(kControllerDefault);
@@ -311,6 +530,11 @@ void LoadWorldDef(World* world, const WorldDef* world_def) {
   world->services_component.set_raft_entity(raft_entity);
 
   world->graph_component.PostLoadFixup();
+
+  // Streamed entities are fixed up as they are created, so this comes last.
+  world->level_streamer.Load(level_def, world);
+
+  world->memory.LogSnapshot("level load");
 }
 
 }  // zooshi
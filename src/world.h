@@ -20,6 +20,7 @@
 #include <string>
 
 #include "admob.h"
+#include "analytics_logger.h"
 #include "components/attributes.h"
 #include "components/audio_listener.h"
 #include "components/lap_dependent.h"
@@ -47,6 +48,8 @@
 #include "corgi_component_library/physics.h"
 #include "corgi_component_library/rendermesh.h"
 #include "corgi_component_library/transform.h"
+#include "edit_dependencies.h"
+#include "game_stats.h"
 
 #include "mathfu/internal/disable_warnings_begin.h"
 
@@ -58,10 +61,16 @@
 #include "fplbase/renderer.h"
 #include "inputcontrollers/base_player_controller.h"
 #include "inputcontrollers/gamepad_controller.h"
+#include "inputcontrollers/input_events.h"
 #include "inputcontrollers/onscreen_controller.h"
 #include "invites.h"
+#include "leaderboard_service.h"
+#include "level_streamer.h"
+#include "memory_accounting.h"
 #include "messaging.h"
 #include "railmanager.h"
+#include "remote_config.h"
+#include "save_manager.h"
 #include "scene_lab/corgi/corgi_adapter.h"
 #include "scene_lab/corgi/edit_options.h"
 #include "scene_lab/scene_lab.h"
@@ -127,8 +136,10 @@ struct World {
                   breadboard::GraphFactory* graph_factory,
                   fplbase::Renderer* renderer, scene_lab::SceneLab* scene_lab,
                   UnlockableManager* unlockable_mgr, XpSystem* xp_system,
-                  InvitesListener* invites_lstr, MessageListener* message_lstr,
-                  AdMobHelper* admob_hlpr);
+                  SaveManager* save_mgr, InvitesListener* invites_lstr,
+                  MessageListener* message_lstr, AdMobHelper* admob_hlpr,
+                  RemoteConfig* remote_cfg,
+                  LeaderboardService* leaderboard_svc);
 
   // Entity manager
   corgi::EntityManager entity_manager;
@@ -166,6 +177,10 @@ struct World {
   corgi::component_library::GraphComponent graph_component;
   Render3dTextComponent render_3d_text_component;
 
+  // Timestamped pointer presses, recorded from the input system after every
+  // input frame and consumed by the player component on the update thread.
+  InputEventQueue input_events;
+
   // Each player has direct control over one entity.
   corgi::EntityRef active_player_entity;
 
@@ -176,6 +191,7 @@ struct World {
 
   UnlockableManager* unlockables;
   XpSystem* xp_system;
+  SaveManager* save_manager;
 
   std::vector<std::unique_ptr<BasePlayerController>> input_controllers;
   OnscreenControllerUI onscreen_controller_ui;
@@ -188,6 +204,22 @@ struct World {
   InvitesListener* invites_listener;
   MessageListener* message_listener;
   AdMobHelper* admob_helper;
+  AnalyticsLogger analytics;
+  RemoteConfig* remote_config;
+  LeaderboardService* leaderboard;
+
+  // Tracks how much memory each component and manager owns.
+  MemoryAccountant memory;
+
+  // Live counters for the stats HUD and logger.
+  StatsRegistry stats;
+
+  // Creates and recycles the current level's streamed entities around the
+  // raft.
+  LevelStreamer level_streamer;
+
+  // Tracks what has to be rebuilt when an entity is edited in Scene Lab.
+  EditDependencyTracker edit_dependencies;
 
   // TODO: Refactor all components so they don't require their source
   // data to remain in memory after their initial load. Then get rid of this,
@@ -209,6 +241,17 @@ struct World {
 
   fplbase::Material* cardboard_settings_gear;
 
+  // Register memory reporters and stats for the components and managers
+  // owned by the world. Other owners register their own.
+  void RegisterDiagnostics();
+
+  // Hook the dependency tracker up to Scene Lab's editing events.
+  void RegisterEditorCallbacks(scene_lab::SceneLab* scene_lab);
+  // Record the derived data built from `entity`, whose Scene Lab id is
+  // `entity_id`.
+  void RecordEditDependencies(const std::string& entity_id,
+                              const corgi::EntityRef& entity);
+
   void AddController(BasePlayerController* controller);
   void SetActiveController(ControllerType controller_type);
   // Reset all controllers back to the default facing values.
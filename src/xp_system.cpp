@@ -16,15 +16,24 @@
 
 #include <fplbase/utilities.h>
 
+#include "save_manager.h"
+
 namespace fpl {
 namespace zooshi {
 
+// Preference used by older versions, before progress moved to the save file.
 const char* kCurrentXPKey = "zooshi.current_xp";
 
-void XpSystem::Initialize(const Config* config) {
+void XpSystem::Initialize(const Config* config, SaveManager* save_manager) {
   config_ = config;
+  save_manager_ = save_manager;
   xp_for_reward_ = config->xp_for_reward();
-  current_xp_ = fplbase::LoadPreference(kCurrentXPKey, 0);
+  if (save_manager->has_progress()) {
+    current_xp_ = save_manager->current_xp();
+  } else {
+    current_xp_ = fplbase::LoadPreference(kCurrentXPKey, 0);
+    save_manager->set_current_xp(current_xp_);
+  }
 }
 
 int XpSystem::ApplyBonuses(int base_xp, bool consume_bonuses) {
@@ -61,7 +70,7 @@ bool XpSystem::GrantXP(int xp) {
     current_xp_ %= xp_for_reward_;
     earned_reward = true;
   }
-  fplbase::SavePreference(kCurrentXPKey, current_xp_);
+  save_manager_->set_current_xp(current_xp_);
   return earned_reward;
 }
 
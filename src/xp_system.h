@@ -28,9 +28,11 @@ enum BonusApplyType {
   BonusApplyType_Size,
 };
 
+class SaveManager;
+
 class XpSystem {
  public:
-  void Initialize(const Config* config);
+  void Initialize(const Config* config, SaveManager* save_manager);
 
   // Applies the tracked bonuses to the given xp value. If consume_bonuses is
   // true, this will consume one application of the bonuses.
@@ -72,6 +74,7 @@ class XpSystem {
   };
 
   const Config* config_;
+  SaveManager* save_manager_;
   int xp_for_reward_;
   int current_xp_;
   std::list<BonusData> bonuses[BonusApplyType_Size];